@@ -190,6 +190,21 @@ if(NOT MSVC)
     CXXFLAGS ${X86_SHANI_CXXFLAGS}
   )
 
+  # Check for x86-64 BMI2 and ADX intrinsics (mulx, adcx and adox).
+  set(X86_ADX_CXXFLAGS -mbmi2 -madx)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      unsigned long long hi, lo;
+      lo = _mulx_u64(1, 2, &hi);
+      return _addcarryx_u64(0, lo, hi, &lo);
+    }
+    " HAVE_X86_ADX
+    CXXFLAGS ${X86_ADX_CXXFLAGS}
+  )
+
   # Check for ARMv8 SHA-NI intrinsics.
   set(ARM_SHANI_CXXFLAGS -march=armv8-a+crypto)
   check_cxx_source_compiles_with_flags("
@@ -0,0 +1,97 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <dbwrapper.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+static constexpr uint32_t NUM_KEYS{100'000};
+
+// Keys written to the databases are even, so odd keys are misses.
+static uint32_t Key(FastRandomContext& rng, bool hit)
+{
+    return (rng.randrange(NUM_KEYS) << 1) | (hit ? 0 : 1);
+}
+
+static CDBWrapper CreateDB(int bloom_bits_per_key)
+{
+    return CDBWrapper{{.path = "dbwrapper_bench", .cache_bytes = 1 << 20, .memory_only = true, .options = {.bloom_bits_per_key = bloom_bits_per_key}}};
+}
+
+// With a 1 MiB cache, the write buffer is small and most entries end up in
+// tables, where bloom filters apply.
+static void FillDB(CDBWrapper& dbw)
+{
+    CDBBatch batch{dbw};
+    for (uint32_t i{0}; i < NUM_KEYS; ++i) {
+        batch.Write(i << 1, uint256{uint8_t(i)});
+        if (batch.ApproximateSize() > 1 << 20) {
+            dbw.WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    dbw.WriteBatch(batch);
+}
+
+static void DBWrapperWriteBatch(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CDBWrapper dbw{CreateDB(/*bloom_bits_per_key=*/10)};
+    bench.batch(1000).unit("write").run([&] {
+        CDBBatch batch{dbw};
+        for (int i{0}; i < 1000; ++i) {
+            batch.Write(Key(rng, /*hit=*/true), uint256{});
+        }
+        dbw.WriteBatch(batch);
+    });
+}
+
+static void ReadDB(benchmark::Bench& bench, int bloom_bits_per_key, int hit_percent)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CDBWrapper dbw{CreateDB(bloom_bits_per_key)};
+    FillDB(dbw);
+    uint256 value;
+    bench.batch(1000).unit("read").run([&] {
+        for (int i{0}; i < 1000; ++i) {
+            const bool hit{int(rng.randrange(100)) < hit_percent};
+            assert(dbw.Read(Key(rng, hit), value) == hit);
+        }
+    });
+}
+
+static void DBWrapperReadHit(benchmark::Bench& bench) { ReadDB(bench, /*bloom_bits_per_key=*/10, /*hit_percent=*/100); }
+static void DBWrapperReadMiss(benchmark::Bench& bench) { ReadDB(bench, /*bloom_bits_per_key=*/10, /*hit_percent=*/0); }
+static void DBWrapperReadMissNoBloom(benchmark::Bench& bench) { ReadDB(bench, /*bloom_bits_per_key=*/0, /*hit_percent=*/0); }
+
+// Mostly reads with some writes, as seen by the chainstate during validation.
+static void DBWrapperReadWriteMix(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CDBWrapper dbw{CreateDB(/*bloom_bits_per_key=*/10)};
+    FillDB(dbw);
+    uint256 value;
+    bench.batch(1000).unit("op").run([&] {
+        CDBBatch batch{dbw};
+        for (int i{0}; i < 1000; ++i) {
+            if (rng.randrange(10) == 0) {
+                batch.Write(Key(rng, /*hit=*/true), uint256{});
+            } else {
+                dbw.Read(Key(rng, rng.randbool()), value);
+            }
+        }
+        dbw.WriteBatch(batch);
+    });
+}
+
+BENCHMARK(DBWrapperWriteBatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadHit, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadMiss, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadMissNoBloom, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DBWrapperReadWriteMix, benchmark::PriorityLevel::HIGH);
@@ -5,8 +5,13 @@
 #include <bench/bench.h>
 #include <blockfilter.h>
 #include <uint256.h>
+#include <util/golombrice.h>
+#include <util/threadpool.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <span>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -86,8 +91,66 @@ static void GCSFilterMatch(benchmark::Bench& bench)
         filter.Match(GCSFilter::Element());
     });
 }
+static void GolombRiceDecodeElements(benchmark::Bench& bench)
+{
+    auto elements = GenerateGCSTestElements();
+
+    GCSFilter filter({0, 0, BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+    // Skip the CompactSize element count, which takes 5 bytes for 100,000 elements.
+    const auto encoded{std::as_bytes(std::span{filter.GetEncoded()}).subspan(5)};
+
+    bench.batch(elements.size()).unit("elem").run([&] {
+        GolombRiceReader reader{encoded, BASIC_FILTER_P};
+        uint64_t value{0};
+        for (size_t i = 0; i < elements.size(); ++i) {
+            value += reader.Read();
+        }
+        ankerl::nanobench::doNotOptimizeAway(value);
+    });
+}
+
+// Match a wallet-sized set of scripts against a few days worth of block
+// filters of a few thousand elements each, as a filter-based rescan would.
+static void MatchManyFilters(benchmark::Bench& bench, int num_workers)
+{
+    std::vector<BlockFilter> filters;
+    for (int i = 0; i < 500; ++i) {
+        GCSFilter::ElementSet elements;
+        for (int j = 0; j < 3000; ++j) {
+            GCSFilter::Element element(32);
+            element[0] = static_cast<unsigned char>(i);
+            element[1] = static_cast<unsigned char>(i >> 8);
+            element[2] = static_cast<unsigned char>(j);
+            element[3] = static_cast<unsigned char>(j >> 8);
+            elements.insert(std::move(element));
+        }
+        const uint256 block_hash{static_cast<uint8_t>(i)};
+        GCSFilter filter({block_hash.GetUint64(0), block_hash.GetUint64(1), BASIC_FILTER_P, BASIC_FILTER_M}, elements);
+        filters.emplace_back(BlockFilterType::BASIC, block_hash, filter.GetEncoded(), /*skip_decode_check=*/true);
+    }
+    GCSFilter::ElementSet queries;
+    for (int i = 0; i < 1000; ++i) {
+        GCSFilter::Element element(22, 0xff);
+        element[0] = static_cast<unsigned char>(i);
+        element[1] = static_cast<unsigned char>(i >> 8);
+        queries.insert(std::move(element));
+    }
+
+    ThreadPool pool{"bench"};
+    pool.Start(num_workers);
+    bench.batch(filters.size()).unit("filter").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(MatchAnyBlockFilters(filters, queries, &pool));
+    });
+}
+
+static void GCSFilterMatchAnyMany(benchmark::Bench& bench) { MatchManyFilters(bench, /*num_workers=*/0); }
+static void GCSFilterMatchAnyManyParallel(benchmark::Bench& bench) { MatchManyFilters(bench, std::max(1, int(std::thread::hardware_concurrency()) - 1)); }
+
 BENCHMARK(GCSBlockFilterGetHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterConstruct, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecode, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterDecodeSkipCheck, benchmark::PriorityLevel::HIGH);
 BENCHMARK(GCSFilterMatch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterMatchAnyMany, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GCSFilterMatchAnyManyParallel, benchmark::PriorityLevel::HIGH);
+BENCHMARK(GolombRiceDecodeElements, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,92 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <chain.h>
+#include <index/addressindex.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <pubkey.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/strencodings.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+using namespace util::hex_literals;
+
+static constexpr int CHAIN_SIZE{600};
+
+static CScript CreateChain(TestChain100Setup& test_setup)
+{
+    CPubKey pubkey{"02ed26169896db86ced4cbb7b3ecef9859b5952825adbeab998fb5b307e54949c9"_hex_u8};
+    CScript script = GetScriptForDestination(WitnessV0KeyHash(pubkey));
+    std::vector<CMutableTransaction> noTxns;
+    for (int i = 0; i < CHAIN_SIZE - 100; i++) {
+        test_setup.CreateAndProcessBlock(noTxns, script);
+        SetMockTime(GetTime() + 1);
+    }
+    assert(WITH_LOCK(::cs_main, return test_setup.m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+    return script;
+}
+
+// Address index sync benchmark, only using coinbase outputs.
+static void AddressIndexSync(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CreateChain(*test_setup);
+
+    bench.minEpochIterations(5).run([&] {
+        AddressIndex address_index(interfaces::MakeChain(test_setup->m_node), /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true);
+        assert(address_index.Init());
+        assert(!address_index.BlockUntilSyncedToCurrentChain());
+        address_index.Sync();
+
+        IndexSummary summary = address_index.GetSummary();
+        assert(summary.synced);
+        assert(summary.best_block_hash == WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip()->GetBlockHash()));
+    });
+}
+
+// Look up a script with an entry in every block from start_height to
+// end_height, optionally reading the transactions from the block files.
+static void AddressIndexLookup(benchmark::Bench& bench, int start_height, int end_height, bool read_txs)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    const uint256 script_hash{AddressIndex::HashScript(CreateChain(*test_setup))};
+
+    AddressIndex address_index(interfaces::MakeChain(test_setup->m_node), /*n_cache_size=*/1 << 20, /*f_memory=*/true);
+    assert(address_index.Init());
+    address_index.Sync();
+
+    const size_t expected_count(end_height - std::max(start_height, 101) + 1);
+    bench.run([&] {
+        if (read_txs) {
+            std::vector<AddressHistoryEntry> history;
+            assert(address_index.FindHistory(script_hash, start_height, end_height, history));
+            assert(history.size() == expected_count);
+        } else {
+            std::vector<AddressIndexBlockPositions> positions;
+            assert(address_index.LookupPositions(script_hash, start_height, end_height, positions));
+            assert(positions.size() == expected_count);
+        }
+    });
+}
+
+static void AddressIndexLookupPositions(benchmark::Bench& bench) { AddressIndexLookup(bench, 0, CHAIN_SIZE, /*read_txs=*/false); }
+static void AddressIndexLookupRange(benchmark::Bench& bench) { AddressIndexLookup(bench, 300, 399, /*read_txs=*/false); }
+static void AddressIndexFindHistory(benchmark::Bench& bench) { AddressIndexLookup(bench, 300, 399, /*read_txs=*/true); }
+
+BENCHMARK(AddressIndexSync, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddressIndexLookupPositions, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddressIndexLookupRange, benchmark::PriorityLevel::HIGH);
+BENCHMARK(AddressIndexFindHistory, benchmark::PriorityLevel::HIGH);
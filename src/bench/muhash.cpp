@@ -0,0 +1,70 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/license/mit/.
+
+#include <bench/bench.h>
+#include <crypto/muhash.h>
+#include <random.h>
+
+#include <vector>
+
+static Num3072 RandomNum3072(FastRandomContext& rng)
+{
+    unsigned char data[Num3072::BYTE_SIZE];
+    rng.fillrand(std::as_writable_bytes(std::span{data}));
+    data[Num3072::BYTE_SIZE - 1] &= 0x7f; // stay below the modulus
+    return Num3072{data};
+}
+
+//! Uses the fastest implementation for this CPU, see MuHash3072AutoDetect().
+static void Num3072Multiply(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    Num3072 acc{RandomNum3072(rng)};
+    const Num3072 mul{RandomNum3072(rng)};
+    bench.run([&] {
+        acc.Multiply(mul);
+    });
+}
+
+static void Num3072MultiplyGeneric(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    Num3072 acc{RandomNum3072(rng)};
+    const Num3072 mul{RandomNum3072(rng)};
+    bench.run([&] {
+        acc.MultiplyGeneric(mul);
+    });
+}
+
+static void Num3072Divide(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    Num3072 acc{RandomNum3072(rng)};
+    const Num3072 div{RandomNum3072(rng)};
+    bench.run([&] {
+        acc.Divide(div);
+    });
+}
+
+//! Insert the coins of a large block and finalize, as CoinStatsIndex does per block.
+static void MuHashInsertFinalize(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<unsigned char>> coins;
+    for (int i = 0; i < 5000; ++i) coins.push_back(rng.randbytes(80));
+    MuHash3072 acc;
+    bench.batch(coins.size()).unit("coin").run([&] {
+        MuHash3072 block;
+        for (const auto& coin : coins) block.Insert(coin);
+        acc *= block;
+        uint256 out;
+        acc.Finalize(out);
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+
+BENCHMARK(Num3072Multiply, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Num3072MultiplyGeneric, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Num3072Divide, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashInsertFinalize, benchmark::PriorityLevel::HIGH);
@@ -9,10 +9,10 @@
 #include <cstddef>
 #include <vector>
 
-static void ObfuscationBench(benchmark::Bench& bench)
+static void ObfuscationBench(benchmark::Bench& bench, size_t size)
 {
     FastRandomContext frc{/*fDeterministic=*/true};
-    auto data{frc.randbytes<std::byte>(1024)};
+    auto data{frc.randbytes<std::byte>(size)};
     const Obfuscation obfuscation{frc.randbytes<Obfuscation::KEY_SIZE>()};
 
     size_t offset{0};
@@ -22,4 +22,14 @@ static void ObfuscationBench(benchmark::Bench& bench)
     });
 }
 
-BENCHMARK(ObfuscationBench, benchmark::PriorityLevel::HIGH);
+static void ObfuscationBench32B(benchmark::Bench& bench) { ObfuscationBench(bench, 32); }
+static void ObfuscationBench128B(benchmark::Bench& bench) { ObfuscationBench(bench, 128); }
+static void ObfuscationBench1KB(benchmark::Bench& bench) { ObfuscationBench(bench, 1024); }
+static void ObfuscationBench64KB(benchmark::Bench& bench) { ObfuscationBench(bench, 64 << 10); }
+static void ObfuscationBench4MB(benchmark::Bench& bench) { ObfuscationBench(bench, 4 << 20); }
+
+BENCHMARK(ObfuscationBench32B, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ObfuscationBench128B, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ObfuscationBench1KB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ObfuscationBench64KB, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ObfuscationBench4MB, benchmark::PriorityLevel::HIGH);
@@ -65,6 +65,20 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
     });
 }
 
+static void ReadRawBlockViewBench(benchmark::Bench& bench)
+{
+    // Only unobfuscated block files are memory-mapped.
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN, {.extra_args = {"-blocksxor=0"}})};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    const auto pos{blockman.WriteBlock(CreateTestBlock(), 413'567)};
+    assert(blockman.ReadRawBlockView(pos)); // warmup
+    bench.run([&] {
+        const auto view{blockman.ReadRawBlockView(pos)};
+        assert(view);
+    });
+}
+
 BENCHMARK(WriteBlockBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadBlockBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(ReadRawBlockBench, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReadRawBlockViewBench, benchmark::PriorityLevel::HIGH);
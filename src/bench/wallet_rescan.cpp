@@ -0,0 +1,74 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <blockfilter.h>
+#include <index/blockfilterindex.h>
+#include <interfaces/chain.h>
+#include <kernel/chainparams.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/time.h>
+#include <validation.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <cassert>
+#include <memory>
+#include <string>
+
+namespace wallet {
+static void WalletRescan(benchmark::Bench& bench, const bool use_filters)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+
+    // Set clock to genesis block, so the descriptors/keys creation time don't interfere with the blocks scanning process.
+    SetMockTime(test_setup->m_node.chainman->GetParams().GenesisBlock().nTime);
+    CWallet wallet{test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase()};
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+    auto handler = test_setup->m_node.chain->handleNotifications({&wallet, [](CWallet*) {}});
+
+    // Only a few blocks pay to the wallet, as in a rescan of a long chain.
+    const std::string address{getnewaddress(wallet)};
+    for (int i = 0; i < 500; ++i) {
+        generatetoaddress(test_setup->m_node, i % 50 == 0 ? address : ADDRESS_BCRT1_UNSPENDABLE);
+    }
+    wallet.chain().waitForNotificationsIfTipChanged(uint256::ZERO);
+
+    if (use_filters) {
+        assert(InitBlockFilterIndex([&] { return interfaces::MakeChain(test_setup->m_node); }, BlockFilterType::BASIC, /*n_cache_size=*/1 << 20, /*f_memory=*/true));
+        BlockFilterIndex& filter_index{*GetBlockFilterIndex(BlockFilterType::BASIC)};
+        assert(filter_index.Init());
+        filter_index.Sync();
+    }
+
+    const uint256 genesis_hash{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    bench.run([&] {
+        WalletRescanReserver reserver(wallet);
+        assert(reserver.reserve());
+        const auto result{wallet.ScanForWalletTransactions(genesis_hash, /*start_height=*/0, /*max_height=*/{}, reserver, /*fUpdate=*/false, /*save_progress=*/false)};
+        assert(result.status == CWallet::ScanResult::SUCCESS);
+        assert(result.last_scanned_height == 500);
+    });
+
+    if (use_filters) {
+        GetBlockFilterIndex(BlockFilterType::BASIC)->Stop();
+        DestroyAllBlockFilterIndexes();
+    }
+}
+
+static void WalletRescanBlocks(benchmark::Bench& bench) { WalletRescan(bench, /*use_filters=*/false); }
+static void WalletRescanBlockFilters(benchmark::Bench& bench) { WalletRescan(bench, /*use_filters=*/true); }
+
+BENCHMARK(WalletRescanBlocks, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WalletRescanBlockFilters, benchmark::PriorityLevel::HIGH);
+} // namespace wallet
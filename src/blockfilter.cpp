@@ -2,12 +2,20 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <mutex>
+#include <optional>
 #include <set>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include <blockfilter.h>
 #include <crypto/siphash.h>
 #include <hash.h>
+#include <pos/stake.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
@@ -15,11 +23,13 @@
 #include <undo.h>
 #include <util/golombrice.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 
 using util::Join;
 
 static const std::map<BlockFilterType, std::string> g_filter_types = {
     {BlockFilterType::BASIC, "basic"},
+    {BlockFilterType::STAKE, "stake"},
 };
 
 uint64_t GCSFilter::HashToRange(const Element& element) const
@@ -61,11 +71,11 @@ GCSFilter::GCSFilter(const Params& params, std::vector<unsigned char> encoded_fi
 
     // Verify that the encoded filter contains exactly N elements. If it has too much or too little
     // data, a std::ios_base::failure exception will be raised.
-    BitStreamReader bitreader{stream};
+    GolombRiceReader reader{std::as_bytes(std::span{m_encoded}).last(stream.size()), m_params.m_P};
     for (uint64_t i = 0; i < m_N; ++i) {
-        GolombRiceDecode(bitreader, m_params.m_P);
+        reader.Read();
     }
-    if (!stream.empty()) {
+    if (reader.BytesRead() != stream.size()) {
         throw std::ios_base::failure("encoded_filter contains excess data");
     }
 }
@@ -108,12 +118,12 @@ bool GCSFilter::MatchInternal(const uint64_t* element_hashes, size_t size) const
     uint64_t N = ReadCompactSize(stream);
     assert(N == m_N);
 
-    BitStreamReader bitreader{stream};
+    GolombRiceReader reader{std::as_bytes(std::span{m_encoded}).last(stream.size()), m_params.m_P};
 
     uint64_t value = 0;
     size_t hashes_index = 0;
     for (uint32_t i = 0; i < m_N; ++i) {
-        uint64_t delta = GolombRiceDecode(bitreader, m_params.m_P);
+        uint64_t delta = reader.Read();
         value += delta;
 
         while (true) {
@@ -206,6 +216,80 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
     return elements;
 }
 
+/** Size of a delegated-stake redeem script, see the delegatestakeaddress RPC:
+ * OP_DUP OP_HASH160 <owner> OP_EQUALVERIFY OP_CHECKSIGVERIFY
+ * OP_DUP OP_HASH160 <staker> OP_EQUALVERIFY OP_CHECKSIG */
+static constexpr size_t DELEGATED_STAKE_SCRIPT_SIZE{50};
+
+/** If the script is a delegated-stake redeem script, return the P2PKH scripts of its owner and staker keys. */
+static std::optional<std::pair<CScript, CScript>> DelegatedStakeKeyScripts(std::span<const unsigned char> script)
+{
+    if (script.size() != DELEGATED_STAKE_SCRIPT_SIZE ||
+        script[0] != OP_DUP || script[1] != OP_HASH160 || script[2] != 20 || script[23] != OP_EQUALVERIFY || script[24] != OP_CHECKSIGVERIFY ||
+        script[25] != OP_DUP || script[26] != OP_HASH160 || script[27] != 20 || script[48] != OP_EQUALVERIFY || script[49] != OP_CHECKSIG) {
+        return std::nullopt;
+    }
+    const auto p2pkh{[](std::span<const unsigned char> key_id) {
+        return CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(key_id.begin(), key_id.end()) << OP_EQUALVERIFY << OP_CHECKSIG;
+    }};
+    return std::pair{p2pkh(script.subspan(3, 20)), p2pkh(script.subspan(28, 20))};
+}
+
+static GCSFilter::ElementSet StakeFilterElements(const CBlock& block,
+                                                 const CBlockUndo& block_undo)
+{
+    GCSFilter::ElementSet elements;
+    const auto add_script{[&](const CScript& script) {
+        if (script.empty() || script[0] == OP_RETURN) return;
+        elements.emplace(script.begin(), script.end());
+    }};
+
+    // The coinstake is the second transaction; its undo data comes first.
+    if (IsProofOfStake(block)) {
+        for (const CTxOut& txout : block.vtx[1]->vout) add_script(txout.scriptPubKey);
+        if (!block_undo.vtxundo.empty()) {
+            for (const Coin& prevout : block_undo.vtxundo[0].vprevout) add_script(prevout.out.scriptPubKey);
+        }
+    }
+
+    // Delegated stake is paid to P2SH, so its keys only show up in the
+    // redeem script, the last push of a spending input's scriptSig.
+    for (size_t i = 1; i < block.vtx.size(); ++i) {
+        for (const CTxIn& txin : block.vtx[i]->vin) {
+            std::vector<unsigned char> last_push;
+            opcodetype opcode;
+            std::vector<unsigned char> data;
+            for (CScript::const_iterator pc{txin.scriptSig.begin()}; txin.scriptSig.GetOp(pc, opcode, data);) {
+                if (opcode > OP_16) {
+                    last_push.clear();
+                    break;
+                }
+                last_push = data;
+            }
+            if (const auto keys{DelegatedStakeKeyScripts(last_push)}) {
+                add_script(keys->first);
+                add_script(keys->second);
+            }
+        }
+    }
+
+    return elements;
+}
+
+static GCSFilter::ElementSet FilterElements(BlockFilterType filter_type, const CBlock& block,
+                                            const CBlockUndo& block_undo)
+{
+    switch (filter_type) {
+    case BlockFilterType::BASIC:
+        return BasicFilterElements(block, block_undo);
+    case BlockFilterType::STAKE:
+        return StakeFilterElements(block, block_undo);
+    case BlockFilterType::INVALID:
+        break;
+    }
+    return {};
+}
+
 BlockFilter::BlockFilter(BlockFilterType filter_type, const uint256& block_hash,
                          std::vector<unsigned char> filter, bool skip_decode_check)
     : m_filter_type(filter_type), m_block_hash(block_hash)
@@ -224,13 +308,14 @@ BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const
     if (!BuildParams(params)) {
         throw std::invalid_argument("unknown filter_type");
     }
-    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    m_filter = GCSFilter(params, FilterElements(m_filter_type, block, block_undo));
 }
 
 bool BlockFilter::BuildParams(GCSFilter::Params& params) const
 {
     switch (m_filter_type) {
     case BlockFilterType::BASIC:
+    case BlockFilterType::STAKE:
         params.m_siphash_k0 = m_block_hash.GetUint64(0);
         params.m_siphash_k1 = m_block_hash.GetUint64(1);
         params.m_P = BASIC_FILTER_P;
@@ -252,3 +337,37 @@ uint256 BlockFilter::ComputeHeader(const uint256& prev_header) const
 {
     return Hash(GetHash(), prev_header);
 }
+
+std::vector<size_t> MatchAnyBlockFilters(std::span<const BlockFilter> filters, const GCSFilter::ElementSet& elements, ThreadPool* pool)
+{
+    const auto match_range{[&filters, &elements](size_t begin, size_t end) {
+        std::vector<size_t> matches;
+        for (size_t i = begin; i < end; ++i) {
+            if (filters[i].GetFilter().MatchAny(elements)) matches.push_back(i);
+        }
+        return matches;
+    }};
+    if (!pool || pool->WorkersCount() == 0) return match_range(0, filters.size());
+
+    // A few chunks per worker, so that uneven filter sizes even out.
+    const size_t chunk_size{std::max<size_t>(16, filters.size() / (pool->WorkersCount() * 4) + 1)};
+    std::vector<std::future<std::vector<size_t>>> chunks;
+    for (size_t begin = 0; begin < filters.size(); begin += chunk_size) {
+        chunks.push_back(pool->Submit([&match_range, begin, end = std::min(begin + chunk_size, filters.size())] {
+            return match_range(begin, end);
+        }));
+    }
+    // Let every chunk finish before collecting results, since they reference
+    // this frame and collecting may throw.
+    for (auto& chunk : chunks) {
+        while (chunk.wait_for(std::chrono::seconds::zero()) != std::future_status::ready) {
+            if (!pool->ProcessTask()) chunk.wait();
+        }
+    }
+    std::vector<size_t> matches;
+    for (auto& chunk : chunks) {
+        const std::vector<size_t> chunk_matches{chunk.get()};
+        matches.insert(matches.end(), chunk_matches.begin(), chunk_matches.end());
+    }
+    return matches;
+}
@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <ios>
 #include <set>
+#include <span>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -20,6 +21,7 @@
 
 class CBlock;
 class CBlockUndo;
+class ThreadPool;
 
 /**
  * This implements a Golomb-coded set as defined in BIP 158. It is a
@@ -92,6 +94,9 @@ constexpr uint32_t BASIC_FILTER_M = 784931;
 enum class BlockFilterType : uint8_t
 {
     BASIC = 0,
+    //! Scripts that proof-of-stake blocks stake from and pay to, and the keys
+    //! behind delegated stake spent in a block, for light staking wallets.
+    STAKE = 1,
     INVALID = 255,
 };
 
@@ -172,4 +177,12 @@ public:
     }
 };
 
+/**
+ * Find the filters that may contain any of the elements, as calling
+ * GetFilter().MatchAny() on each of them would. If a pool is given, chunks of
+ * filters are matched concurrently on it. Returns the indexes of the matching
+ * filters in increasing order.
+ */
+std::vector<size_t> MatchAnyBlockFilters(std::span<const BlockFilter> filters, const GCSFilter::ElementSet& elements, ThreadPool* pool = nullptr);
+
 #endif // BITCOIN_BLOCKFILTER_H
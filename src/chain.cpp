@@ -26,6 +26,14 @@ void CChain::SetTip(CBlockIndex& block)
         vChain[pindex->nHeight] = pindex;
         pindex = pindex->pprev;
     }
+    auto snapshot{std::make_shared<const ChainTipSnapshot>(ChainTipSnapshot{
+        .tip = &block,
+        .height = block.nHeight,
+        .median_time_past = block.GetMedianTimePast(),
+        .chain_work = block.nChainWork,
+    })};
+    // The previous snapshot is released after the lock, in case this was the last reference.
+    WITH_LOCK(m_tip_snapshot_mutex, m_tip_snapshot.swap(snapshot));
 }
 
 std::vector<uint256> LocatorEntries(const CBlockIndex* index)
@@ -17,8 +17,10 @@
 #include <util/time.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -412,11 +414,24 @@ public:
     std::string ToString() = delete;
 };
 
+/** Immutable summary of a chain tip, which can be read without holding cs_main. */
+struct ChainTipSnapshot {
+    const CBlockIndex* tip;
+    int height;
+    int64_t median_time_past;
+    arith_uint256 chain_work;
+};
+
 /** An in-memory indexed chain of blocks. */
 class CChain
 {
 private:
     std::vector<CBlockIndex*> vChain;
+    //! Replaced on every SetTip(), so readers never see a partially updated
+    //! tip. The mutex is only held to copy the pointer, so readers do not
+    //! contend with the lock that guards the chain.
+    mutable Mutex m_tip_snapshot_mutex;
+    std::shared_ptr<const ChainTipSnapshot> m_tip_snapshot GUARDED_BY(m_tip_snapshot_mutex);
 
 public:
     CChain() = default;
@@ -465,7 +480,17 @@ public:
     }
 
     /** Set/initialize a chain with a given tip. */
-    void SetTip(CBlockIndex& block);
+    void SetTip(CBlockIndex& block) EXCLUSIVE_LOCKS_REQUIRED(!m_tip_snapshot_mutex);
+
+    /**
+     * Return the tip as of the last SetTip(), or nullptr if the chain is empty.
+     * Unlike Tip() and Height(), this does not require the lock that guards
+     * the chain. The snapshot may be outdated by the time it is used.
+     */
+    std::shared_ptr<const ChainTipSnapshot> TipSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(!m_tip_snapshot_mutex)
+    {
+        return WITH_LOCK(m_tip_snapshot_mutex, return m_tip_snapshot);
+    }
 
     /** Return a CBlockLocator that refers to the tip in of this chain. */
     CBlockLocator GetLocator() const;
@@ -34,6 +34,131 @@ bool CCoinsViewBacked::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &h
 std::unique_ptr<CCoinsViewCursor> CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
+CCoinsViewShared::CCoinsViewShared(CCoinsView* view, size_t max_bytes, bool deterministic)
+    : CCoinsViewBacked(view), m_generation_max_bytes(max_bytes / NUM_SHARDS / 2), m_hasher(deterministic) {}
+
+std::optional<Coin> CCoinsViewShared::GetCachedCoin(const COutPoint& outpoint) const
+{
+    if (!m_generation_max_bytes) return std::nullopt;
+    const Shard& shard{GetShard(outpoint)};
+    std::shared_lock lock{shard.mutex};
+    // Look at the current generation first, it holds the most recent writes.
+    for (size_t i : {shard.current, shard.current ^ 1}) {
+        if (auto it{shard.generations[i].find(outpoint)}; it != shard.generations[i].end()) return it->second;
+    }
+    return std::nullopt;
+}
+
+std::optional<Coin> CCoinsViewShared::GetCoin(const COutPoint& outpoint) const
+{
+    if (auto coin{GetCachedCoin(outpoint)}) {
+        if (coin->IsSpent()) return std::nullopt;
+        return coin;
+    }
+    return base->GetCoin(outpoint);
+}
+
+bool CCoinsViewShared::HaveCoin(const COutPoint& outpoint) const
+{
+    if (auto coin{GetCachedCoin(outpoint)}) return !coin->IsSpent();
+    return base->HaveCoin(outpoint);
+}
+
+void CCoinsViewShared::Insert(const COutPoint& outpoint, const Coin& coin)
+{
+    static const size_t ENTRY_USAGE{memusage::MallocUsage(sizeof(memusage::unordered_node<std::pair<const COutPoint, Coin>>))};
+    const size_t usage{ENTRY_USAGE + coin.DynamicMemoryUsage()};
+
+    Shard& shard{GetShard(outpoint)};
+    std::unique_lock lock{shard.mutex};
+    for (size_t i : {0, 1}) {
+        if (auto it{shard.generations[i].find(outpoint)}; it != shard.generations[i].end()) {
+            shard.usage[i] -= ENTRY_USAGE + it->second.DynamicMemoryUsage();
+            shard.generations[i].erase(it);
+        }
+    }
+    if (shard.usage[shard.current] + usage > m_generation_max_bytes) {
+        // The current generation is full: drop the previous one and reuse it.
+        shard.current ^= 1;
+        shard.generations[shard.current].clear();
+        shard.usage[shard.current] = 0;
+    }
+    shard.generations[shard.current].emplace(outpoint, coin);
+    shard.usage[shard.current] += usage;
+}
+
+bool CCoinsViewShared::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock)
+{
+    if (!m_generation_max_bytes) return base->BatchWrite(cursor, hashBlock);
+
+    // Collect the changes before the cursor is consumed by the base view.
+    // Spent entries may be erased by it, so only their outpoint is kept;
+    // unspent entries stay alive until the caller wipes or cleans its cache.
+    std::vector<std::pair<COutPoint, const Coin*>> changes;
+    for (auto it{cursor.Begin()}; it != cursor.End(); it = it->second.Next()) {
+        if (!it->second.IsDirty()) continue;
+        // FRESH coins are unknown to the base view, and hence to this tier.
+        if (it->second.IsFresh() && it->second.coin.IsSpent()) continue;
+        changes.emplace_back(it->first, it->second.coin.IsSpent() ? nullptr : &it->second.coin);
+    }
+
+    // Publish only once the base view has been written. Until then readers
+    // see the old state of a coin from the tier, or the old or new state from
+    // the base, but never the new state followed by the old one. Publishing
+    // first would allow a tombstone to be rotated out before the base write,
+    // exposing the old unspent coin again.
+    bool written{false};
+    try {
+        written = base->BatchWrite(cursor, hashBlock);
+    } catch (...) {
+        Clear();
+        throw;
+    }
+    if (!written) {
+        // The base is in an undefined state, so let readers fall through to it
+        // rather than serving entries that may not reflect it.
+        Clear();
+        return false;
+    }
+    static const Coin spent{};
+    for (const auto& [outpoint, coin] : changes) {
+        Insert(outpoint, coin ? *coin : spent);
+    }
+    return true;
+}
+
+void CCoinsViewShared::Clear()
+{
+    for (Shard& shard : m_shards) {
+        std::unique_lock lock{shard.mutex};
+        for (Map& map : shard.generations) {
+            map.clear();
+            map.rehash(0);
+        }
+        shard.usage = {};
+    }
+}
+
+size_t CCoinsViewShared::GetCacheSize() const
+{
+    size_t count{0};
+    for (const Shard& shard : m_shards) {
+        std::shared_lock lock{shard.mutex};
+        count += shard.generations[0].size() + shard.generations[1].size();
+    }
+    return count;
+}
+
+size_t CCoinsViewShared::DynamicMemoryUsage() const
+{
+    size_t usage{0};
+    for (const Shard& shard : m_shards) {
+        std::shared_lock lock{shard.mutex};
+        usage += shard.usage[0] + shard.usage[1];
+    }
+    return usage;
+}
+
 CCoinsViewCache::CCoinsViewCache(CCoinsView* baseIn, bool deterministic) :
     CCoinsViewBacked(baseIn), m_deterministic(deterministic),
     cacheCoins(0, SaltedOutpointHasher(/*deterministic=*/deterministic), CCoinsMap::key_equal{}, &m_cache_coins_memory_resource)
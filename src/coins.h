@@ -16,10 +16,12 @@
 #include <util/check.h>
 #include <util/hasher.h>
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 
 #include <functional>
+#include <shared_mutex>
 #include <unordered_map>
 
 /**
@@ -358,6 +360,77 @@ public:
 };
 
 
+/**
+ * CCoinsView that keeps a bounded, concurrently readable copy of the coins
+ * most recently written through it.
+ *
+ * It is meant to sit between the on-disk coins database and the cs_main
+ * guarded CCoinsViewCache. Every DIRTY entry passed to BatchWrite is recorded
+ * here (spent coins as tombstones) once the base view has been written, so
+ * that this tier together with its base reflects the last flushed state, and
+ * a reader never sees a coin go back to an older state. If the base write
+ * fails the tier is cleared.
+ *
+ * GetCachedCoin() only takes a shared lock on a single shard and never touches
+ * the base view, so it may be called from any thread without holding cs_main.
+ * GetCoin() and HaveCoin() fall through to the base view on a miss, and are
+ * only as thread-safe as the base view is.
+ *
+ * Each shard keeps two generations of entries. Once the current generation
+ * exceeds half of the shard's share of the memory budget it replaces the
+ * previous one, which is dropped. Cache misses are never inserted, as a read
+ * racing with a flush could otherwise resurrect a spent coin.
+ *
+ * A budget of 0 disables the tier and turns this into a pass-through view.
+ */
+class CCoinsViewShared final : public CCoinsViewBacked
+{
+public:
+    static constexpr size_t NUM_SHARDS{16};
+
+    CCoinsViewShared(CCoinsView* view, size_t max_bytes, bool deterministic = false);
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256& hashBlock) override;
+
+    /**
+     * Look up an outpoint in this tier only, without consulting the base view.
+     * Returns std::nullopt if the outpoint is not cached, and a spent Coin if
+     * it is cached as spent.
+     */
+    std::optional<Coin> GetCachedCoin(const COutPoint& outpoint) const;
+
+    //! Drop all cached entries.
+    void Clear();
+
+    //! Number of cached entries, including tombstones.
+    size_t GetCacheSize() const;
+
+    //! Estimated memory usage of the cached entries (in bytes).
+    size_t DynamicMemoryUsage() const;
+
+private:
+    using Map = std::unordered_map<COutPoint, Coin, SaltedOutpointHasher>;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        //! The current and previous generation, which swap roles on rotation.
+        std::array<Map, 2> generations;
+        std::array<size_t, 2> usage{};
+        size_t current{0};
+    };
+
+    //! Memory budget of a single generation within a shard.
+    const size_t m_generation_max_bytes;
+    const SaltedOutpointHasher m_hasher;
+    mutable std::array<Shard, NUM_SHARDS> m_shards;
+
+    Shard& GetShard(const COutPoint& outpoint) const { return m_shards[m_hasher(outpoint) % NUM_SHARDS]; }
+    void Insert(const COutPoint& outpoint, const Coin& coin);
+};
+
+
 /** CCoinsView that adds a memory cache for transactions to another CCoinsView */
 class CCoinsViewCache : public CCoinsViewBacked
 {
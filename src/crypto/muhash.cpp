@@ -4,6 +4,7 @@
 
 #include <crypto/muhash.h>
 
+#include <compat/cpuid.h>
 #include <crypto/chacha20.h>
 #include <crypto/common.h>
 #include <hash.h>
@@ -121,6 +122,15 @@ bool Num3072::IsOverflow() const
     return true;
 }
 
+bool Num3072::IsOne() const
+{
+    if (this->limbs[0] != 1) return false;
+    for (int i = 1; i < LIMBS; ++i) {
+        if (this->limbs[i] != 0) return false;
+    }
+    return true;
+}
+
 void Num3072::FullReduce()
 {
     limb_t c0 = MAX_PRIME_DIFF;
@@ -452,7 +462,66 @@ Num3072 Num3072::GetInverse() const
     return ret;
 }
 
+#if defined(ENABLE_X86_ADX)
+namespace muhash_x86_adx {
+/** Defined in muhash_x86_adx.cpp. Sets r to a value below 2^3072 that is congruent to r * a. */
+void Multiply(uint64_t* r, const uint64_t* a);
+} // namespace muhash_x86_adx
+#endif
+
+namespace {
+
+#if defined(ENABLE_X86_ADX) && defined(HAVE_GETCPUID) && defined(__SIZEOF_INT128__)
+bool HaveX86Adx()
+{
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(0, 0, eax, ebx, ecx, edx);
+    if (eax < 7) return false;
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+    const bool have_bmi2{((ebx >> 8) & 1) != 0};
+    const bool have_adx{((ebx >> 19) & 1) != 0};
+    return have_bmi2 && have_adx;
+}
+#endif
+
+struct MultiplyImplementation {
+    bool use_x86_adx{false};
+    std::string name{"standard"};
+};
+
+const MultiplyImplementation& GetMultiplyImplementation()
+{
+    static const MultiplyImplementation implementation{[] {
+        MultiplyImplementation ret;
+#if defined(ENABLE_X86_ADX) && defined(HAVE_GETCPUID) && defined(__SIZEOF_INT128__)
+        if (HaveX86Adx()) ret = {true, "x86_adx"};
+#endif
+        return ret;
+    }()};
+    return implementation;
+}
+
+} // namespace
+
+std::string MuHash3072AutoDetect()
+{
+    return GetMultiplyImplementation().name;
+}
+
 void Num3072::Multiply(const Num3072& a)
+{
+#if defined(ENABLE_X86_ADX) && defined(__SIZEOF_INT128__)
+    if (GetMultiplyImplementation().use_x86_adx) {
+        static_assert(LIMB_SIZE == 64);
+        muhash_x86_adx::Multiply(this->limbs, a.limbs);
+        if (this->IsOverflow()) this->FullReduce();
+        return;
+    }
+#endif
+    MultiplyGeneric(a);
+}
+
+void Num3072::MultiplyGeneric(const Num3072& a)
 {
     limb_t c0 = 0, c1 = 0, c2 = 0;
     Num3072 tmp;
@@ -498,6 +567,8 @@ void Num3072::SetToOne()
 void Num3072::Divide(const Num3072& a)
 {
     if (this->IsOverflow()) this->FullReduce();
+    // Dividing by one, e.g. finalizing a normalized MuHash3072, needs no inverse.
+    if (a.IsOne()) return;
 
     Num3072 inv{};
     if (a.IsOverflow()) {
@@ -548,10 +619,16 @@ MuHash3072::MuHash3072(std::span<const unsigned char> in) noexcept
     m_numerator = ToNum3072(in);
 }
 
-void MuHash3072::Finalize(uint256& out) noexcept
+MuHash3072& MuHash3072::Normalize() noexcept
 {
     m_numerator.Divide(m_denominator);
-    m_denominator.SetToOne();  // Needed to keep the MuHash object valid
+    m_denominator.SetToOne();
+    return *this;
+}
+
+void MuHash3072::Finalize(uint256& out) noexcept
+{
+    Normalize();
 
     unsigned char data[Num3072::BYTE_SIZE];
     m_numerator.ToBytes(data);
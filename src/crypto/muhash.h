@@ -9,12 +9,14 @@
 #include <uint256.h>
 
 #include <cstdint>
+#include <string>
 
 class Num3072
 {
 private:
     void FullReduce();
     bool IsOverflow() const;
+    bool IsOne() const;
     Num3072 GetInverse() const;
 
 public:
@@ -52,6 +54,9 @@ public:
     static_assert(sizeof(limb_t) == 4 || sizeof(limb_t) == 8, "bad size for limb_t");
 
     void Multiply(const Num3072& a);
+    /** Portable implementation of Multiply(), used when the CPU has no faster
+     * one (see MuHash3072AutoDetect()). Exposed for tests and benchmarks. */
+    void MultiplyGeneric(const Num3072& a);
     void Divide(const Num3072& a);
     void SetToOne();
     void ToBytes(unsigned char (&out)[BYTE_SIZE]);
@@ -67,6 +72,9 @@ public:
     }
 };
 
+/** Return the name of the Num3072 multiplication implementation, selecting the fastest available one on first use. */
+std::string MuHash3072AutoDetect();
+
 /** A class representing MuHash sets
  *
  * MuHash is a hashing algorithm that supports adding set elements in any
@@ -123,6 +131,13 @@ public:
     /* Divide (resulting in a hash for the difference of the sets) */
     MuHash3072& operator/=(const MuHash3072& div) noexcept;
 
+    /* Fold the denominator into the numerator, at the cost of one modular
+     * inverse. Merging a normalized object into another one that has no
+     * denominator keeps it that way, and finalizing such an object does not
+     * need an inverse, so the inverses of many partial results can be
+     * computed in parallel. Does not change the represented set. */
+    MuHash3072& Normalize() noexcept;
+
     /* Finalize into a 32-byte hash. Does not change this object's value. */
     void Finalize(uint256& out) noexcept;
 
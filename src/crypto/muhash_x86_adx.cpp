@@ -0,0 +1,95 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_X86_ADX
+
+#include <cstdint>
+#include <immintrin.h>
+
+namespace muhash_x86_adx {
+
+// This file is compiled with BMI2 and ADX enabled, so it must not include
+// headers with inline functions that could also be used by code running
+// without them. The limb layout matches Num3072 with 64-bit limbs.
+static constexpr int LIMBS{48};
+/** 2^3072 - MAX_PRIME_DIFF is the modulus. */
+static constexpr uint64_t MAX_PRIME_DIFF{1103717};
+
+/** t[0..LIMBS] += b * a[0..LIMBS-1], where t[LIMBS] is zero on input.
+ *
+ * The low halves of the mulx products are added on the carry flag chain
+ * (adcx) and the high halves on the overflow flag chain (adox), so the two
+ * additions do not wait for each other. Compilers do not keep two flag
+ * chains alive through intrinsics, hence the assembly; the loop only uses
+ * instructions that leave the flags alone (lea, jrcxz, mov, mulx).
+ */
+inline void MulAddRow(unsigned long long* t, const uint64_t* a, uint64_t b)
+{
+    unsigned long long n = LIMBS;
+    unsigned long long lo, hi;
+    __asm__ volatile(
+        "xorl %%r8d, %%r8d\n" // clear CF and OF
+        "1:\n"
+        "jrcxz 2f\n"
+        "mulx (%[a]), %[lo], %[hi]\n"
+        "adcx (%[t]), %[lo]\n"
+        "movq %[lo], (%[t])\n"
+        "adox 8(%[t]), %[hi]\n"
+        "movq %[hi], 8(%[t])\n"
+        "leaq 8(%[a]), %[a]\n"
+        "leaq 8(%[t]), %[t]\n"
+        "leaq -1(%%rcx), %%rcx\n"
+        "jmp 1b\n"
+        "2:\n"
+        "movq (%[t]), %[lo]\n"
+        "adcx %%r8, %[lo]\n"
+        "movq %[lo], (%[t])\n"
+        : [t] "+r"(t), [a] "+r"(a), "+c"(n), [lo] "=&r"(lo), [hi] "=&r"(hi)
+        : "d"(b)
+        : "r8", "cc", "memory");
+}
+
+void Multiply(uint64_t* r, const uint64_t* a)
+{
+    // Schoolbook product into 2 * LIMBS limbs, one row per limb of r. Row i
+    // only touches t[i..i+LIMBS], and t[i+LIMBS] is still zero before it.
+    unsigned long long t[2 * LIMBS] = {};
+    for (int i = 0; i < LIMBS; ++i) MulAddRow(t + i, a, r[i]);
+
+    // Fold the high half in: 2^3072 is MAX_PRIME_DIFF modulo the modulus.
+    unsigned long long top{0};
+    {
+        unsigned char cf{0}, of{0};
+        for (int j = 0; j < LIMBS; ++j) {
+            unsigned long long hi;
+            const unsigned long long lo{_mulx_u64(t[LIMBS + j], MAX_PRIME_DIFF, &hi)};
+            cf = _addcarryx_u64(cf, t[j], lo, &t[j]);
+            if (j + 1 < LIMBS) {
+                of = _addcarryx_u64(of, t[j + 1], hi, &t[j + 1]);
+            } else {
+                top = hi + of;
+            }
+        }
+        top += cf;
+    }
+
+    // Fold the remaining top limb (below 2^22) in the same way. This can carry
+    // out of the last limb at most once, and only when the low limbs are then
+    // small, so folding that carry in cannot carry out again.
+    unsigned long long hi;
+    unsigned long long lo{_mulx_u64(top, MAX_PRIME_DIFF, &hi)};
+    unsigned char cf{_addcarryx_u64(0, t[0], lo, &t[0])};
+    cf = _addcarryx_u64(cf, t[1], hi, &t[1]);
+    for (int j = 2; j < LIMBS; ++j) cf = _addcarryx_u64(cf, t[j], 0, &t[j]);
+    if (cf) {
+        cf = _addcarryx_u64(0, t[0], MAX_PRIME_DIFF, &t[0]);
+        for (int j = 1; j < LIMBS; ++j) cf = _addcarryx_u64(cf, t[j], 0, &t[j]);
+    }
+
+    for (int j = 0; j < LIMBS; ++j) r[j] = t[j];
+}
+
+} // namespace muhash_x86_adx
+
+#endif // ENABLE_X86_ADX
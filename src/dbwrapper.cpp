@@ -9,13 +9,17 @@
 #include <serialize.h>
 #include <span.h>
 #include <streams.h>
+#include <sync.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/obfuscation.h>
 #include <util/strencodings.h>
+#include <util/thread.h>
+#include <util/threadinterrupt.h>
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
@@ -29,9 +33,13 @@
 #include <leveldb/slice.h>
 #include <leveldb/status.h>
 #include <leveldb/write_batch.h>
+#include <list>
 #include <memory>
+#include <numeric>
 #include <optional>
+#include <thread>
 #include <utility>
+#include <vector>
 
 static auto CharCast(const std::byte* data) { return reinterpret_cast<const char*>(data); }
 
@@ -135,12 +143,15 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const DBOptions& db_options)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    const size_t percent(std::clamp(db_options.block_cache_percent, 0, 100));
+    const size_t block_cache_size{nCacheSize / 100 * percent + nCacheSize % 100 * percent / 100};
+    options.block_cache = leveldb::NewLRUCache(block_cache_size);
+    options.write_buffer_size = (nCacheSize - block_cache_size) / 2; // up to two write buffers may be held in memory simultaneously
+    options.filter_policy = db_options.bloom_bits_per_key > 0 ? leveldb::NewBloomFilterPolicy(db_options.bloom_bits_per_key) : nullptr;
+    options.block_size = db_options.block_size;
     options.compression = leveldb::kNoCompression;
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
@@ -148,11 +159,96 @@ static leveldb::Options GetOptions(size_t nCacheSize)
         // on corruption in later versions.
         options.paranoid_checks = true;
     }
-    options.max_file_size = std::max(options.max_file_size, DBWRAPPER_MAX_FILE_SIZE);
+    options.max_file_size = std::max(options.max_file_size, db_options.max_file_size);
     SetMaxOpenFiles(&options);
+    LogDebug(BCLog::LEVELDB, "LevelDB using block_cache=%d write_buffer=%d bloom_bits_per_key=%d block_size=%d max_file_size=%d\n",
+             block_cache_size, options.write_buffer_size, db_options.bloom_bits_per_key, options.block_size, options.max_file_size);
     return options;
 }
 
+namespace {
+struct CompactionEntry {
+    CDBWrapper* db;
+    //! Key the next step starts compacting from.
+    std::string next_key;
+    //! Set while a step compacts the database without g_compaction_mutex.
+    bool busy{false};
+};
+//! Databases opened with DBOptions::background_compaction. A list, so that
+//! entries stay valid while others are added or removed.
+Mutex g_compaction_mutex;
+std::condition_variable g_compaction_cv;
+std::list<CompactionEntry> g_compaction_dbs GUARDED_BY(g_compaction_mutex);
+
+CThreadInterrupt g_compaction_interrupt;
+std::thread g_compaction_thread;
+
+/**
+ * Return a key between a and b (a < b) in key order, by treating the keys as
+ * base-256 fractions and averaging them.
+ */
+std::string MidKey(const std::string& a, const std::string& b)
+{
+    const size_t len{std::max(a.size(), b.size()) + 1};
+    std::vector<unsigned> sum(len + 1);
+    unsigned carry{0};
+    for (size_t i = len; i-- > 0;) {
+        const unsigned digit{(i < a.size() ? uint8_t(a[i]) : 0U) + (i < b.size() ? uint8_t(b[i]) : 0U) + carry};
+        sum[i + 1] = digit & 0xff;
+        carry = digit >> 8;
+    }
+    sum[0] = carry;
+    std::string mid(len, '\0');
+    unsigned rem{sum[0] & 1};
+    for (size_t i = 0; i < len; ++i) {
+        const unsigned v{rem * 256 + sum[i + 1]};
+        mid[i] = char(v / 2);
+        rem = v & 1;
+    }
+    return mid;
+}
+} // namespace
+
+size_t BackgroundCompactionStep(uint64_t max_bytes)
+{
+    size_t count{0};
+    WAIT_LOCK(g_compaction_mutex, lock);
+    for (auto it{g_compaction_dbs.begin()}; it != g_compaction_dbs.end(); ++it) {
+        // Compact without holding the mutex, so that other databases can be
+        // opened and closed meanwhile. Closing this one waits for busy.
+        it->busy = true;
+        const std::string begin{it->next_key};
+        std::string next_key;
+        {
+            REVERSE_LOCK(lock, g_compaction_mutex);
+            next_key = it->db->CompactNextRange(begin, max_bytes);
+        }
+        it->next_key = std::move(next_key);
+        it->busy = false;
+        g_compaction_cv.notify_all();
+        ++count;
+    }
+    return count;
+}
+
+void StartBackgroundCompaction(std::function<bool()> paused)
+{
+    assert(!g_compaction_thread.joinable());
+    g_compaction_interrupt.reset();
+    g_compaction_thread = std::thread(&util::TraceThread, "dbcompact", [paused = std::move(paused)] {
+        while (g_compaction_interrupt.sleep_for(DB_BACKGROUND_COMPACTION_INTERVAL)) {
+            if (!paused()) BackgroundCompactionStep();
+        }
+    });
+}
+
+void StopBackgroundCompaction()
+{
+    if (!g_compaction_thread.joinable()) return;
+    g_compaction_interrupt();
+    g_compaction_thread.join();
+}
+
 struct CDBBatch::WriteBatchImpl {
     leveldb::WriteBatch batch;
 };
@@ -214,14 +310,15 @@ struct LevelDBContext {
 };
 
 CDBWrapper::CDBWrapper(const DBParams& params)
-    : m_db_context{std::make_unique<LevelDBContext>()}, m_name{fs::PathToString(params.path.stem())}, m_path{params.path}, m_is_memory{params.memory_only}
+    : m_db_context{std::make_unique<LevelDBContext>()}, m_name{fs::PathToString(params.path.stem())}, m_path{params.path}, m_is_memory{params.memory_only},
+      m_background_compaction{params.options.background_compaction}
 {
     DBContext().penv = nullptr;
     DBContext().readoptions.verify_checksums = true;
     DBContext().iteroptions.verify_checksums = true;
     DBContext().iteroptions.fill_cache = false;
     DBContext().syncoptions.sync = true;
-    DBContext().options = GetOptions(params.cache_bytes);
+    DBContext().options = GetOptions(params.cache_bytes, params.options);
     DBContext().options.create_if_missing = true;
     if (params.memory_only) {
         DBContext().penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -257,10 +354,21 @@ CDBWrapper::CDBWrapper(const DBParams& params)
         LogInfo("Wrote new obfuscation key for %s: %s", fs::PathToString(params.path), m_obfuscation.HexKey());
     }
     LogInfo("Using obfuscation key for %s: %s", fs::PathToString(params.path), m_obfuscation.HexKey());
+
+    if (m_background_compaction) {
+        LOCK(g_compaction_mutex);
+        g_compaction_dbs.push_back({.db = this, .next_key = {}});
+    }
 }
 
 CDBWrapper::~CDBWrapper()
 {
+    if (m_background_compaction) {
+        WAIT_LOCK(g_compaction_mutex, lock);
+        const auto it{std::find_if(g_compaction_dbs.begin(), g_compaction_dbs.end(), [this](const CompactionEntry& entry) { return entry.db == this; })};
+        g_compaction_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(g_compaction_mutex) { return !it->busy; });
+        g_compaction_dbs.erase(it);
+    }
     delete DBContext().pdb;
     DBContext().pdb = nullptr;
     delete DBContext().options.filter_policy;
@@ -301,33 +409,57 @@ size_t CDBWrapper::DynamicMemoryUsage() const
     return parsed.value();
 }
 
-std::optional<std::string> CDBWrapper::ReadImpl(std::span<const std::byte> key) const
+DataStream& CDBWrapper::KeyBuffer()
+{
+    thread_local DataStream buffer{[] { DataStream stream; stream.reserve(DBWRAPPER_PREALLOC_KEY_SIZE); return stream; }()};
+    return buffer;
+}
+
+std::string& CDBWrapper::ValueBuffer()
+{
+    thread_local std::string buffer{[] { std::string str; str.reserve(DBWRAPPER_PREALLOC_VALUE_SIZE); return str; }()};
+    return buffer;
+}
+
+bool CDBWrapper::ReadImpl(std::span<const std::byte> key, std::string& value) const
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
-    std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
+    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &value);
     if (!status.ok()) {
         if (status.IsNotFound())
-            return std::nullopt;
+            return false;
         LogPrintf("LevelDB read failure: %s\n", status.ToString());
         HandleError(status);
     }
-    return strValue;
+    return true;
 }
 
-bool CDBWrapper::ExistsImpl(std::span<const std::byte> key) const
+void CDBWrapper::ReadManyImpl(std::span<const std::span<const std::byte>> keys, const std::function<void(size_t, std::span<std::byte>)>& found) const
 {
-    leveldb::Slice slKey(CharCast(key.data()), key.size());
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&](size_t a, size_t b) { return std::ranges::lexicographical_compare(keys[a], keys[b]); });
 
+    leveldb::ReadOptions readoptions{DBContext().readoptions};
+    readoptions.snapshot = DBContext().pdb->GetSnapshot();
     std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
-    if (!status.ok()) {
-        if (status.IsNotFound())
-            return false;
-        LogPrintf("LevelDB read failure: %s\n", status.ToString());
-        HandleError(status);
+    for (const size_t i : order) {
+        leveldb::Slice slKey(CharCast(keys[i].data()), keys[i].size());
+        leveldb::Status status = DBContext().pdb->Get(readoptions, slKey, &strValue);
+        if (!status.ok()) {
+            if (status.IsNotFound()) continue;
+            DBContext().pdb->ReleaseSnapshot(readoptions.snapshot);
+            LogPrintf("LevelDB read failure: %s\n", status.ToString());
+            HandleError(status);
+        }
+        found(i, MakeWritableByteSpan(strValue));
     }
-    return true;
+    DBContext().pdb->ReleaseSnapshot(readoptions.snapshot);
+}
+
+bool CDBWrapper::ExistsImpl(std::span<const std::byte> key) const
+{
+    return ReadImpl(key, ValueBuffer());
 }
 
 size_t CDBWrapper::EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const
@@ -340,6 +472,45 @@ size_t CDBWrapper::EstimateSizeImpl(std::span<const std::byte> key1, std::span<c
     return size;
 }
 
+void CDBWrapper::CompactRangeImpl(std::span<const std::byte> begin, std::span<const std::byte> end)
+{
+    const leveldb::Slice slBegin(CharCast(begin.data()), begin.size());
+    const leveldb::Slice slEnd(CharCast(end.data()), end.size());
+    DBContext().pdb->CompactRange(&slBegin, end.empty() ? nullptr : &slEnd);
+}
+
+std::string CDBWrapper::CompactNextRange(const std::string& begin, uint64_t max_bytes)
+{
+    std::string limit;
+    {
+        std::unique_ptr<leveldb::Iterator> it{DBContext().pdb->NewIterator(DBContext().iteroptions)};
+        it->SeekToLast();
+        if (!it->Valid()) return {};
+        // The smallest key after the last one.
+        limit = it->key().ToString() + '\0';
+    }
+    if (begin >= limit) return {};
+
+    const auto estimate{[&](const std::string& end) {
+        return EstimateSizeImpl(MakeByteSpan(begin), MakeByteSpan(end));
+    }};
+    if (estimate(limit) <= max_bytes) {
+        CompactRangeImpl(MakeByteSpan(begin), {});
+        return {};
+    }
+    // Bisect the key space for an end key with about max_bytes of data
+    // before it. This splits within a shared key prefix too, since the
+    // estimates come from the table index blocks and not from the keys.
+    std::string lo{begin}, hi{limit};
+    for (int i = 0; i < 32; ++i) {
+        std::string mid{MidKey(lo, hi)};
+        if (mid <= lo || mid >= hi) break;
+        (estimate(mid) < max_bytes ? lo : hi) = std::move(mid);
+    }
+    CompactRangeImpl(MakeByteSpan(begin), MakeByteSpan(hi));
+    return hi;
+}
+
 bool CDBWrapper::IsEmpty()
 {
     std::unique_ptr<CDBIterator> it(NewIterator());
@@ -12,21 +12,45 @@
 #include <util/check.h>
 #include <util/fs.h>
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 static const size_t DBWRAPPER_MAX_FILE_SIZE = 32 << 20; // 32 MiB
+//! Interval between two steps of the background compaction, see BackgroundCompactionStep().
+static constexpr auto DB_BACKGROUND_COMPACTION_INTERVAL{std::chrono::seconds{10}};
+//! Approximate amount of table data compacted per database in one background compaction step.
+static constexpr uint64_t DB_BACKGROUND_COMPACTION_STEP_BYTES{16 << 20};
 
 //! User-controlled performance and debug options.
 struct DBOptions {
     //! Compact database on startup.
     bool force_compact = false;
+    //! Maximum size of a table file. Larger files mean fewer files to open
+    //! and fewer, larger compactions.
+    size_t max_file_size = DBWRAPPER_MAX_FILE_SIZE;
+    //! Bits per key of the bloom filter, 0 to disable it. Filters save disk
+    //! reads on lookups of missing keys, but not on iteration.
+    int bloom_bits_per_key = 10;
+    //! Size of the data blocks read from disk. Smaller blocks suit point
+    //! lookups, larger blocks suit iteration.
+    size_t block_size = 4 << 10;
+    //! Percentage of the cache size used for the block cache. The rest is
+    //! split between the two write buffers that may be held in memory.
+    int block_cache_percent = 50;
+    //! Compact the database a key range at a time in the background.
+    bool background_compaction = false;
 };
 
 //! Application-specific storage settings.
@@ -67,6 +91,24 @@ const Obfuscation& GetObfuscation(const CDBWrapper&);
 
 bool DestroyDB(const std::string& path_str);
 
+/**
+ * Compact the next key range of every database opened with
+ * DBOptions::background_compaction. Each range holds about max_bytes of
+ * table data, with split points chosen from LevelDB's size estimates, so a
+ * database is compacted over many calls instead of stalling writers at once.
+ * The next call continues after the range, and wraps around at the end of
+ * the database. Returns the number of databases compacted.
+ */
+size_t BackgroundCompactionStep(uint64_t max_bytes = DB_BACKGROUND_COMPACTION_STEP_BYTES);
+
+/**
+ * Start a thread calling BackgroundCompactionStep() every
+ * DB_BACKGROUND_COMPACTION_INTERVAL, skipping steps while paused() is true.
+ */
+void StartBackgroundCompaction(std::function<bool()> paused);
+//! Stop the thread started by StartBackgroundCompaction(), if any.
+void StopBackgroundCompaction();
+
 /** Batch of changes queued to be written to a CDBWrapper */
 class CDBBatch
 {
@@ -178,6 +220,7 @@ struct LevelDBContext;
 class CDBWrapper
 {
     friend const Obfuscation& dbwrapper_private::GetObfuscation(const CDBWrapper&);
+    friend size_t BackgroundCompactionStep(uint64_t max_bytes);
 private:
     //! holds all leveldb-specific fields of this class
     std::unique_ptr<LevelDBContext> m_db_context;
@@ -197,9 +240,25 @@ private:
     //! whether or not the database resides in memory
     bool m_is_memory;
 
-    std::optional<std::string> ReadImpl(std::span<const std::byte> key) const;
+    //! whether the database is registered for BackgroundCompactionStep()
+    bool m_background_compaction;
+
+    //! Per-thread key and value buffers, reused by Read() and Exists() so
+    //! that lookups do not allocate once the buffers have grown.
+    static DataStream& KeyBuffer();
+    static std::string& ValueBuffer();
+
+    //! Read the value of key into value, returning false if it is missing.
+    bool ReadImpl(std::span<const std::byte> key, std::string& value) const;
     bool ExistsImpl(std::span<const std::byte> key) const;
     size_t EstimateSizeImpl(std::span<const std::byte> key1, std::span<const std::byte> key2) const;
+    //! Read keys from a single snapshot in key order, calling found(i, value) for every keys[i] present.
+    void ReadManyImpl(std::span<const std::span<const std::byte>> keys, const std::function<void(size_t, std::span<std::byte>)>& found) const;
+    //! Compact the keys from begin to end, where an empty end means the end of the database.
+    void CompactRangeImpl(std::span<const std::byte> begin, std::span<const std::byte> end);
+    //! Compact about max_bytes of table data starting at begin. Returns the
+    //! key to continue from, or an empty key after reaching the end.
+    std::string CompactNextRange(const std::string& begin, uint64_t max_bytes);
     auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
 
 public:
@@ -212,23 +271,63 @@ public:
     template <typename K, typename V>
     bool Read(const K& key, V& value) const
     {
-        DataStream ssKey{};
-        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+        DataStream& ssKey{KeyBuffer()};
+        ssKey.clear();
         ssKey << key;
-        std::optional<std::string> strValue{ReadImpl(ssKey)};
-        if (!strValue) {
+        std::string& strValue{ValueBuffer()};
+        if (!ReadImpl(ssKey, strValue)) {
             return false;
         }
         try {
-            DataStream ssValue{MakeByteSpan(*strValue)};
-            m_obfuscation(ssValue);
-            ssValue >> value;
+            const auto value_bytes{MakeWritableByteSpan(strValue)};
+            m_obfuscation(value_bytes);
+            SpanReader{value_bytes} >> value;
         } catch (const std::exception&) {
             return false;
         }
         return true;
     }
 
+    /**
+     * Read the values of many keys at once. values[i] is set to the value of
+     * keys[i], or std::nullopt if it is missing or does not deserialize. The
+     * keys are serialized into a single buffer and looked up in key order
+     * from one snapshot, so the values are consistent with each other and
+     * neighbouring keys share table block reads. Returns the number of values
+     * found.
+     */
+    template <typename K, typename V>
+    size_t ReadMany(std::span<const K> keys, std::span<std::optional<V>> values) const
+    {
+        assert(keys.size() == values.size());
+        DataStream ssKeys{};
+        ssKeys.reserve(keys.size() * DBWRAPPER_PREALLOC_KEY_SIZE / 2);
+        std::vector<size_t> key_ends;
+        key_ends.reserve(keys.size());
+        for (const K& key : keys) {
+            ssKeys << key;
+            key_ends.push_back(ssKeys.size());
+        }
+        std::vector<std::span<const std::byte>> key_spans;
+        key_spans.reserve(keys.size());
+        for (size_t i{0}, begin{0}; i < keys.size(); begin = key_ends[i++]) {
+            key_spans.emplace_back(std::span{ssKeys}.subspan(begin, key_ends[i] - begin));
+        }
+
+        std::ranges::fill(values, std::nullopt);
+        size_t found{0};
+        ReadManyImpl(key_spans, [&](size_t i, std::span<std::byte> value) {
+            try {
+                m_obfuscation(value);
+                SpanReader{value} >> values[i].emplace();
+                ++found;
+            } catch (const std::exception&) {
+                values[i].reset();
+            }
+        });
+        return found;
+    }
+
     template <typename K, typename V>
     bool Write(const K& key, const V& value, bool fSync = false)
     {
@@ -248,8 +347,8 @@ public:
     template <typename K>
     bool Exists(const K& key) const
     {
-        DataStream ssKey{};
-        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+        DataStream& ssKey{KeyBuffer()};
+        ssKey.clear();
         ssKey << key;
         return ExistsImpl(ssKey);
     }
@@ -0,0 +1,246 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/addressindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <script/script.h>
+#include <undo.h>
+#include <util/check.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <map>
+
+constexpr uint8_t DB_ADDRESSINDEX{'a'};
+
+std::unique_ptr<AddressIndex> g_address_index;
+
+namespace {
+
+struct DBAddressKey {
+    uint256 script_hash;
+    int height;
+
+    explicit DBAddressKey(const uint256& hash_in, int height_in) : script_hash(hash_in), height(height_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_ADDRESSINDEX);
+        s << script_hash;
+        // Big-endian, so that the entries of a script are iterated in height order.
+        ser_writedata32be(s, height);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_ADDRESSINDEX) {
+            throw std::ios_base::failure("Invalid format for addressindex DB key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+    }
+};
+
+using BlockScriptPositions = std::map<uint256, std::vector<AddressIndexPosition>>;
+
+/** Collect the positions of all scripts funded or spent in a block. */
+BlockScriptPositions GetBlockScriptPositions(const interfaces::BlockInfo& block)
+{
+    BlockScriptPositions result;
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return result;
+
+    const CBlock& data{*Assert(block.data)};
+    const CBlockUndo& undo{*Assert(block.undo_data)};
+    uint32_t tx_offset = GetSizeOfCompactSize(data.vtx.size());
+    for (size_t i = 0; i < data.vtx.size(); ++i) {
+        const CTransaction& tx{*data.vtx[i]};
+        if (i > 0) {
+            const CTxUndo& tx_undo{undo.vtxundo.at(i - 1)};
+            for (size_t j = 0; j < tx.vin.size(); ++j) {
+                result[AddressIndex::HashScript(tx_undo.vprevout.at(j).out.scriptPubKey)].push_back({.tx_offset = tx_offset, .n = uint32_t(j), .spending = true});
+            }
+        }
+        for (size_t j = 0; j < tx.vout.size(); ++j) {
+            const CScript& script{tx.vout[j].scriptPubKey};
+            if (script.empty() || script.IsUnspendable()) continue;
+            result[AddressIndex::HashScript(script)].push_back({.tx_offset = tx_offset, .n = uint32_t(j), .spending = false});
+        }
+        tx_offset += ::GetSerializeSize(TX_WITH_WITNESS(tx));
+    }
+    return result;
+}
+
+} // namespace
+
+/** Access to the addressindex database (indexes/addressindex/) */
+class AddressIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the positions of a block's scripts to the DB.
+    [[nodiscard]] bool WritePositions(int height, const FlatFilePos& block_pos, const BlockScriptPositions& positions);
+
+    /// Erase the positions of a block's scripts from the DB.
+    [[nodiscard]] bool ErasePositions(int height, const BlockScriptPositions& positions);
+
+    /// Read the positions of a script in a range of heights.
+    bool ReadPositions(const uint256& script_hash, int start_height, int end_height,
+                       std::vector<AddressIndexBlockPositions>& positions_out, size_t max_positions);
+};
+
+AddressIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "addressindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool AddressIndex::DB::WritePositions(int height, const FlatFilePos& block_pos, const BlockScriptPositions& positions)
+{
+    CDBBatch batch(*this);
+    AddressIndexBlockPositions value{.height = height, .block_pos = block_pos, .positions = {}};
+    for (const auto& [script_hash, script_positions] : positions) {
+        value.positions = script_positions;
+        batch.Write(DBAddressKey(script_hash, height), value);
+    }
+    return WriteBatch(batch);
+}
+
+bool AddressIndex::DB::ErasePositions(int height, const BlockScriptPositions& positions)
+{
+    CDBBatch batch(*this);
+    for (const auto& entry : positions) {
+        batch.Erase(DBAddressKey(entry.first, height));
+    }
+    return WriteBatch(batch);
+}
+
+bool AddressIndex::DB::ReadPositions(const uint256& script_hash, int start_height, int end_height,
+                                     std::vector<AddressIndexBlockPositions>& positions_out, size_t max_positions)
+{
+    size_t num_positions{0};
+    std::unique_ptr<CDBIterator> db_it(NewIterator());
+    for (db_it->Seek(DBAddressKey(script_hash, start_height)); num_positions < max_positions && db_it->Valid(); db_it->Next()) {
+        DBAddressKey key(uint256::ZERO, 0);
+        if (!db_it->GetKey(key) || key.script_hash != script_hash || key.height > end_height) break;
+
+        AddressIndexBlockPositions value;
+        if (!db_it->GetValue(value)) {
+            LogError("unable to read value for script %s at height %d", script_hash.ToString(), key.height);
+            return false;
+        }
+        value.height = key.height;
+        num_positions += value.positions.size();
+        positions_out.push_back(std::move(value));
+    }
+    return true;
+}
+
+AddressIndex::AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "addressindex"), m_db(std::make_unique<AddressIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+AddressIndex::~AddressIndex() = default;
+
+uint256 AddressIndex::HashScript(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+interfaces::Chain::NotifyOptions AddressIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    options.disconnect_undo_data = true;
+    return options;
+}
+
+std::any AddressIndex::CustomPrepareBlock(const interfaces::BlockInfo& block)
+{
+    return GetBlockScriptPositions(block);
+}
+
+bool AddressIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    const auto& positions{std::any_cast<const BlockScriptPositions&>(prepared)};
+    if (positions.empty()) return true;
+    return m_db->WritePositions(block.height, {block.file_number, block.data_pos}, positions);
+}
+
+bool AddressIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    const BlockScriptPositions positions{GetBlockScriptPositions(block)};
+    if (positions.empty()) return true;
+    return m_db->ErasePositions(block.height, positions);
+}
+
+BaseIndex::DB& AddressIndex::GetDB() const { return *m_db; }
+
+bool AddressIndex::LookupPositions(const uint256& script_hash, int start_height, int end_height,
+                                   std::vector<AddressIndexBlockPositions>& positions_out, size_t max_positions) const
+{
+    return m_db->ReadPositions(script_hash, std::max(start_height, 0), end_height, positions_out, max_positions);
+}
+
+bool AddressIndex::FindHistory(const uint256& script_hash, int start_height, int end_height,
+                               std::vector<AddressHistoryEntry>& history_out, size_t skip, size_t count) const
+{
+    if (count == 0) return true;
+    std::vector<AddressIndexBlockPositions> blocks;
+    const size_t max_positions{skip > std::numeric_limits<size_t>::max() - count ? std::numeric_limits<size_t>::max() : skip + count};
+    if (!LookupPositions(script_hash, start_height, end_height, blocks, max_positions)) return false;
+
+    for (const AddressIndexBlockPositions& block : blocks) {
+        if (count == 0) break;
+        // Blocks with only skipped positions are not read at all.
+        if (skip >= block.positions.size()) {
+            skip -= block.positions.size();
+            continue;
+        }
+        AutoFile file{m_chainstate->m_blockman.OpenBlockFile(block.block_pos, true)};
+        if (file.IsNull()) {
+            LogError("OpenBlockFile failed");
+            return false;
+        }
+        try {
+            CBlockHeader header;
+            file >> header;
+            const uint256 block_hash{header.GetHash()};
+            // Positions are sorted by offset, so the block is read forward
+            // only, and each transaction once.
+            uint32_t file_offset{0};
+            uint32_t tx_offset{0};
+            CTransactionRef tx;
+            for (size_t i = skip; i < block.positions.size() && count > 0; ++i) {
+                const AddressIndexPosition& pos{block.positions[i]};
+                if (!tx || pos.tx_offset != tx_offset) {
+                    file.seek(int64_t{pos.tx_offset} - file_offset, SEEK_CUR);
+                    file >> TX_WITH_WITNESS(tx);
+                    tx_offset = pos.tx_offset;
+                    file_offset = tx_offset + ::GetSerializeSize(TX_WITH_WITNESS(*tx));
+                }
+                if (pos.n >= (pos.spending ? tx->vin.size() : tx->vout.size())) {
+                    LogError("position %u is out of range for tx %s", pos.n, tx->GetHash().ToString());
+                    return false;
+                }
+                history_out.push_back({.height = block.height, .block_hash = block_hash, .tx = tx, .n = pos.n, .spending = pos.spending});
+                --count;
+            }
+            skip = 0;
+        } catch (const std::exception& e) {
+            LogError("Deserialize or I/O error - %s", e.what());
+            return false;
+        }
+    }
+    return true;
+}
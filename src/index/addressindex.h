@@ -0,0 +1,148 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_ADDRESSINDEX_H
+#define BITCOIN_INDEX_ADDRESSINDEX_H
+
+#include <flatfile.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <uint256.h>
+
+#include <cstdint>
+#include <ios>
+#include <limits>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_ADDRESSINDEX{false};
+//! Number of history entries returned by getaddresshistory and REST unless a count is given
+static constexpr size_t DEFAULT_ADDRESS_HISTORY_COUNT{1000};
+//! Maximum number of history entries returned by one getaddresshistory or REST request
+static constexpr size_t MAX_ADDRESS_HISTORY_COUNT{10000};
+
+/** A transaction output paying to, or a transaction input spending from, an indexed script. */
+struct AddressIndexPosition {
+    //! Offset of the transaction after the block header, as in CDiskTxPos.
+    uint32_t tx_offset{0};
+    //! Output index for funding positions, input index for spending ones.
+    uint32_t n{0};
+    bool spending{false};
+
+    friend bool operator==(const AddressIndexPosition&, const AddressIndexPosition&) = default;
+};
+
+/**
+ * All positions of one script in one block. The positions are stored as a
+ * list of varints, with transaction offsets delta-encoded, so most positions
+ * take two or three bytes.
+ */
+struct AddressIndexBlockPositions {
+    int height{0};
+    FlatFilePos block_pos;
+    //! Sorted by transaction offset.
+    std::vector<AddressIndexPosition> positions;
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << block_pos;
+        WriteCompactSize(s, positions.size());
+        uint32_t prev_offset{0};
+        for (const AddressIndexPosition& pos : positions) {
+            s << VARINT(pos.tx_offset - prev_offset);
+            s << VARINT((uint64_t{pos.n} << 1) | pos.spending);
+            prev_offset = pos.tx_offset;
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        s >> block_pos;
+        const uint64_t count{ReadCompactSize(s)};
+        positions.clear();
+        uint32_t prev_offset{0};
+        for (uint64_t i = 0; i < count; ++i) {
+            uint32_t offset_delta;
+            uint64_t n_and_flag;
+            s >> VARINT(offset_delta) >> VARINT(n_and_flag);
+            if ((n_and_flag >> 1) > UINT32_MAX) throw std::ios_base::failure("Invalid addressindex position");
+            prev_offset += offset_delta;
+            positions.push_back({.tx_offset = prev_offset, .n = uint32_t(n_and_flag >> 1), .spending = bool(n_and_flag & 1)});
+        }
+    }
+};
+
+/** A funding or spending transaction of an indexed script, resolved from an AddressIndexPosition. */
+struct AddressHistoryEntry {
+    int height{0};
+    uint256 block_hash;
+    CTransactionRef tx;
+    uint32_t n{0};
+    bool spending{false};
+};
+
+/**
+ * AddressIndex is used to look up the transactions that pay to or spend from
+ * a script, by the SHA256 hash of the script. For every script and block, the
+ * index stores the positions of the script's outputs and inputs in the block,
+ * keyed by script hash and height so that a script's history can be iterated
+ * over a range of heights.
+ */
+class AddressIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return false; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    std::any CustomPrepareBlock(const interfaces::BlockInfo& block) override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit AddressIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~AddressIndex() override;
+
+    /// The key under which a script's positions are indexed.
+    static uint256 HashScript(const CScript& script);
+
+    /// Look up the positions of a script in the blocks from start_height to
+    /// end_height (inclusive), in height order. Stops after the block that
+    /// brings the number of positions to max_positions.
+    ///
+    /// @return  false on a database error; true otherwise, including if the script was not found.
+    bool LookupPositions(const uint256& script_hash, int start_height, int end_height,
+                         std::vector<AddressIndexBlockPositions>& positions_out,
+                         size_t max_positions = std::numeric_limits<size_t>::max()) const;
+
+    /// Look up the positions of a script like LookupPositions(), and read the
+    /// transactions at those positions from the block files. The first skip
+    /// positions are passed over without reading their blocks, and at most
+    /// count entries are returned.
+    bool FindHistory(const uint256& script_hash, int start_height, int end_height,
+                     std::vector<AddressHistoryEntry>& history_out,
+                     size_t skip = 0, size_t count = std::numeric_limits<size_t>::max()) const;
+};
+
+/// The global address index. May be null.
+extern std::unique_ptr<AddressIndex> g_address_index;
+
+#endif // BITCOIN_INDEX_ADDRESSINDEX_H
@@ -17,10 +17,13 @@
 #include <undo.h>
 #include <util/string.h>
 #include <util/thread.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 
 #include <chrono>
+#include <deque>
+#include <future>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -32,6 +35,15 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! Number of blocks per sync worker that are read and prepared ahead of the block being appended.
+constexpr int SYNC_BLOCKS_AHEAD_PER_WORKER{8};
+
+struct BaseIndex::PreparedBlock {
+    CBlock block;
+    CBlockUndo block_undo;
+    std::any data;
+    std::string error;
+};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -40,6 +52,40 @@ void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, co
     node::AbortNode(m_chain->context()->shutdown_request, m_chain->context()->exit_status, Untranslated(message), m_chain->context()->warnings.get());
 }
 
+bool IndexCommitGroup::Commit(CDBWrapper& db, CDBBatch& batch)
+{
+    bool result{false};
+    WAIT_LOCK(m_mutex, lock);
+    const uint64_t group{m_next_group};
+    m_pending.push_back({&db, &batch, &result});
+    m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_written_group >= group || !m_writing; });
+    if (m_written_group >= group) return result;
+
+    // Write this group. Commits arriving in the meantime join the next one.
+    m_writing = true;
+    ++m_next_group;
+    std::vector<Pending> members;
+    members.swap(m_pending);
+    {
+        REVERSE_LOCK(lock, m_mutex);
+        for (const Pending& member : members) {
+            *member.result = member.db->WriteBatch(*member.batch);
+        }
+    }
+    m_groups += 1;
+    m_commits += members.size();
+    m_written_group = group;
+    m_writing = false;
+    m_cv.notify_all();
+    return result;
+}
+
+IndexCommitGroup& GetIndexCommitGroup()
+{
+    static IndexCommitGroup g_index_commit_group;
+    return g_index_commit_group;
+}
+
 CBlockLocator GetLocator(interfaces::Chain& chain, const uint256& block_hash)
 {
     CBlockLocator locator;
@@ -56,7 +102,17 @@ BaseIndex::DB::DB(const fs::path& path, size_t n_cache_size, bool f_memory, bool
         .memory_only = f_memory,
         .wipe_data = f_wipe,
         .obfuscate = f_obfuscate,
-        .options = [] { DBOptions options; node::ReadDatabaseArgs(gArgs, options); return options; }()}}
+        .options = [&path] {
+            // Databases under indexes/ are named after their directory there.
+            const fs::path relative{path.lexically_relative(gArgs.GetDataDirNet() / "indexes")};
+            const std::string name{relative.empty() || *relative.begin() == ".." ? "index" : fs::PathToString(*relative.begin())};
+            DBOptions options;
+            if (auto result{node::ReadDatabaseArgs(gArgs, options, name)}; !result) {
+                LogWarning("%s, using the default database options for %s", util::ErrorString(result).original, name);
+                options = DBOptions{};
+            }
+            return options;
+        }()}}
 {}
 
 bool BaseIndex::DB::ReadBestBlock(CBlockLocator& locator) const
@@ -165,7 +221,7 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
 
     CBlockUndo block_undo;
     if (CustomOptions().connect_undo_data) {
-        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
+        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex, CustomOptions().undo_columns)) {
             FatalErrorf("Failed to read undo block data %s from disk",
                         pindex->GetBlockHash().ToString());
             return false;
@@ -173,7 +229,7 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
         block_info.undo_data = &block_undo;
     }
 
-    if (!CustomAppend(block_info)) {
+    if (!CustomAppendPrepared(block_info, CustomPrepareBlock(block_info))) {
         FatalErrorf("Failed to write block %s to index database",
                     pindex->GetBlockHash().ToString());
         return false;
@@ -182,12 +238,43 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
     return true;
 }
 
+std::shared_ptr<BaseIndex::PreparedBlock> BaseIndex::PrepareBlock(const CBlockIndex* pindex)
+{
+    auto prepared{std::make_shared<PreparedBlock>()};
+    if (!m_chainstate->m_blockman.ReadBlock(prepared->block, *pindex)) {
+        prepared->error = strprintf("Failed to read block %s from disk", pindex->GetBlockHash().ToString());
+        return prepared;
+    }
+    interfaces::BlockInfo block_info{kernel::MakeBlockInfo(pindex, &prepared->block)};
+    if (CustomOptions().connect_undo_data) {
+        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(prepared->block_undo, *pindex, CustomOptions().undo_columns)) {
+            prepared->error = strprintf("Failed to read undo block data %s from disk", pindex->GetBlockHash().ToString());
+            return prepared;
+        }
+        block_info.undo_data = &prepared->block_undo;
+    }
+    prepared->data = CustomPrepareBlock(block_info);
+    return prepared;
+}
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
+
+        // With workers, blocks following the one being appended are read,
+        // deserialized and prepared on the pool, while this thread appends
+        // them to the index in chain order.
+        std::optional<ThreadPool> pool;
+        std::deque<std::pair<const CBlockIndex*, std::future<std::shared_ptr<PreparedBlock>>>> ahead;
+        if (m_sync_workers > 0) {
+            pool.emplace(strprintf("%s.sync", GetName()));
+            pool->Start(m_sync_workers);
+        }
+        const size_t max_ahead{size_t(m_sync_workers) * SYNC_BLOCKS_AHEAD_PER_WORKER};
+
         while (true) {
             if (m_interrupt) {
                 LogInfo("%s: m_interrupt set; exiting ThreadSync", GetName());
@@ -226,8 +313,32 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
-
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            if (pool) {
+                // Anything queued for another branch is stale after a rewind.
+                if (!ahead.empty() && ahead.front().first != pindex) ahead.clear();
+                {
+                    LOCK(::cs_main);
+                    const CBlockIndex* next{ahead.empty() ? pindex : m_chainstate->m_chain.Next(ahead.back().first)};
+                    for (; next && ahead.size() < max_ahead; next = m_chainstate->m_chain.Next(next)) {
+                        ahead.emplace_back(next, pool->Submit([this, next] { return PrepareBlock(next); }));
+                    }
+                }
+                const std::shared_ptr<PreparedBlock> prepared{pool->Wait(ahead.front().second)};
+                ahead.pop_front();
+                if (!prepared->error.empty()) {
+                    FatalErrorf("%s", prepared->error);
+                    return;
+                }
+                interfaces::BlockInfo block_info{kernel::MakeBlockInfo(pindex, &prepared->block)};
+                if (CustomOptions().connect_undo_data) block_info.undo_data = &prepared->block_undo;
+                if (!CustomAppendPrepared(block_info, std::move(prepared->data))) {
+                    FatalErrorf("Failed to write block %s to index database",
+                                pindex->GetBlockHash().ToString());
+                    return;
+                }
+            } else if (!ProcessBlock(pindex)) {
+                return; // error logged internally
+            }
 
             auto current_time{std::chrono::steady_clock::now()};
             if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
@@ -236,7 +347,10 @@ void BaseIndex::Sync()
                 last_log_time = current_time;
             }
 
-            if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
+            // Commit at the same points in time as other syncing indexes, so
+            // that their commits are written as one group.
+            if (last_locator_write_time.time_since_epoch() / SYNC_LOCATOR_WRITE_INTERVAL !=
+                current_time.time_since_epoch() / SYNC_LOCATOR_WRITE_INTERVAL) {
                 SetBestBlockIndex(pindex);
                 last_locator_write_time = current_time;
                 // No need to handle errors in Commit. See rationale above.
@@ -262,7 +376,13 @@ bool BaseIndex::Commit()
         ok = CustomCommit(batch);
         if (ok) {
             GetDB().WriteBestBlock(batch, GetLocator(*m_chain, m_best_block_index.load()->GetBlockHash()));
-            ok = GetDB().WriteBatch(batch);
+            const auto start{SteadyClock::now()};
+            ok = GetIndexCommitGroup().Commit(GetDB(), batch);
+            const auto latency{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start)};
+            m_commits += 1;
+            m_last_commit_latency = latency;
+            auto max_latency{m_max_commit_latency.load()};
+            while (latency > max_latency && !m_max_commit_latency.compare_exchange_weak(max_latency, latency)) {}
         }
     }
     if (!ok) {
@@ -291,7 +411,7 @@ bool BaseIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_ti
             block_info.data = &block;
         }
         if (CustomOptions().disconnect_undo_data && iter_tip->nHeight > 0) {
-            if (!m_chainstate->m_blockman.ReadBlockUndo(block_undo, *iter_tip)) {
+            if (!m_chainstate->m_blockman.ReadBlockUndo(block_undo, *iter_tip, CustomOptions().undo_columns)) {
                 return false;
             }
             block_info.undo_data = &block_undo;
@@ -475,6 +595,9 @@ IndexSummary BaseIndex::GetSummary() const
         summary.best_block_height = 0;
         summary.best_block_hash = m_chain->getBlockHash(0);
     }
+    summary.commits = m_commits;
+    summary.last_commit_latency = m_last_commit_latency;
+    summary.max_commit_latency = m_max_commit_latency;
     return summary;
 }
 
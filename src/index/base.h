@@ -8,11 +8,19 @@
 #include <dbwrapper.h>
 #include <interfaces/chain.h>
 #include <interfaces/types.h>
+#include <sync.h>
 #include <util/string.h>
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 class CBlock;
 class CBlockIndex;
@@ -22,13 +30,61 @@ namespace interfaces {
 class Chain;
 } // namespace interfaces
 
+/** Default for -indexworkers, the number of threads preparing blocks during the initial index sync. */
+static constexpr int DEFAULT_INDEX_WORKERS{0};
+static constexpr int MAX_INDEX_WORKERS{16};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
     int best_block_height{0};
     uint256 best_block_hash;
+    uint64_t commits{0};
+    std::chrono::microseconds last_commit_latency{0};
+    std::chrono::microseconds max_commit_latency{0};
 };
 
+/**
+ * Writes the commits of several indexes together ("group commit").
+ *
+ * Commits that are submitted while a group is being written form the next
+ * group. The first thread to submit to a group writes the batches of all its
+ * members while the other members wait for it. Index commits happen at the
+ * same points in time (see BaseIndex::Sync()), so concurrently syncing indexes
+ * share one writer. The writes are not synced: an index that
+ * loses its last commits in a crash catches up from its best block.
+ */
+class IndexCommitGroup
+{
+    struct Pending {
+        CDBWrapper* db;
+        CDBBatch* batch;
+        bool* result;
+    };
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Pending> m_pending GUARDED_BY(m_mutex);
+    //! Number of the group that new commits join, and of the last group written.
+    uint64_t m_next_group GUARDED_BY(m_mutex){1};
+    uint64_t m_written_group GUARDED_BY(m_mutex){0};
+    bool m_writing GUARDED_BY(m_mutex){false};
+
+    std::atomic<uint64_t> m_groups{0};
+    std::atomic<uint64_t> m_commits{0};
+
+public:
+    /** Write a batch, together with those of concurrent callers. Returns whether the write succeeded. */
+    bool Commit(CDBWrapper& db, CDBBatch& batch) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Number of groups written, and of commits written in them.
+    uint64_t GroupCount() const { return m_groups; }
+    uint64_t CommitCount() const { return m_commits; }
+};
+
+/** The commit group shared by all indexes. */
+IndexCommitGroup& GetIndexCommitGroup();
+
 /**
  * Base class for indices of blockchain data. This implements
  * CValidationInterface and ensures blocks are indexed sequentially according
@@ -80,6 +136,18 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Number of worker threads used by Sync(); 0 processes blocks on the sync thread only.
+    int m_sync_workers{DEFAULT_INDEX_WORKERS};
+
+    /// Commit latency metrics, reported by GetSummary().
+    std::atomic<uint64_t> m_commits{0};
+    std::atomic<std::chrono::microseconds> m_last_commit_latency{};
+    std::atomic<std::chrono::microseconds> m_max_commit_latency{};
+
+    /// A block read from disk, with its undo data and the result of
+    /// CustomPrepareBlock(), ready to be appended to the index.
+    struct PreparedBlock;
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -95,6 +163,10 @@ private:
 
     bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr);
 
+    /// Read a block and its undo data and call CustomPrepareBlock(). Safe to
+    /// call from worker threads.
+    std::shared_ptr<PreparedBlock> PrepareBlock(const CBlockIndex* pindex);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -118,6 +190,17 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Compute the parts of a block's index entries that do not depend on
+    /// the index state, e.g. a block filter. During the initial sync this is
+    /// called on worker threads, concurrently and out of order for different
+    /// blocks, so it must not access mutable index state.
+    [[nodiscard]] virtual std::any CustomPrepareBlock(const interfaces::BlockInfo& block) { return {}; }
+
+    /// Write index entries for a block, in chain order, using the result of
+    /// CustomPrepareBlock(). Indexes that override CustomPrepareBlock() must
+    /// override this as well.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) { return CustomAppend(block); }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -154,6 +237,11 @@ public:
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
+    /// Set the number of threads that read and prepare blocks ahead of the
+    /// sync thread during the initial sync. Must be called before
+    /// StartBackgroundSync().
+    void SetSyncWorkers(int workers) { m_sync_workers = workers; }
+
     /// Sync the index with the block index starting from the current best block.
     /// Intended to be run in its own thread, m_thread_sync, and can be
     /// interrupted with m_interrupt. Once the index gets in sync, the m_synced
@@ -116,6 +116,8 @@ interfaces::Chain::NotifyOptions BlockFilterIndex::CustomOptions()
 {
     interfaces::Chain::NotifyOptions options;
     options.connect_undo_data = true;
+    // Filters only commit to the scripts of the spent outputs.
+    options.undo_columns = undo_column::SCRIPTS;
     return options;
 }
 
@@ -271,9 +273,14 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
     return read_out.second.header;
 }
 
-bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::any BlockFilterIndex::CustomPrepareBlock(const interfaces::BlockInfo& block)
 {
-    BlockFilter filter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+    return BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    const BlockFilter& filter{*Assert(std::any_cast<BlockFilter>(&prepared))};
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
     if (res) m_last_header = header; // update last header
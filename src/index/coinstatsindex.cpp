@@ -59,6 +59,23 @@ struct DBVal {
     }
 };
 
+/** The changes a block makes to the UTXO set statistics. They do not depend
+ * on the index state, so they can be computed for many blocks in parallel. */
+struct BlockStatsDelta {
+    //! Product of the created coins over the product of the spent ones.
+    MuHash3072 muhash;
+    uint64_t outputs_added{0};
+    uint64_t outputs_removed{0};
+    uint64_t bogo_size_added{0};
+    uint64_t bogo_size_removed{0};
+    CAmount prevout_spent_amount{0};
+    CAmount new_outputs_ex_coinbase_amount{0};
+    CAmount coinbase_amount{0};
+    CAmount unspendable_amount{0};
+    CAmount unspendables_bip30{0};
+    CAmount unspendables_scripts{0};
+};
+
 struct DBHeightKey {
     int height;
 
@@ -112,7 +129,74 @@ CoinStatsIndex::CoinStatsIndex(std::unique_ptr<interfaces::Chain> chain, size_t
     m_db = std::make_unique<CoinStatsIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
 }
 
-bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
+std::any CoinStatsIndex::CustomPrepareBlock(const interfaces::BlockInfo& block)
+{
+    BlockStatsDelta delta;
+    // Ignore genesis block
+    if (block.height == 0) return delta;
+
+    // Add the new utxos created from the block
+    assert(block.data);
+    for (size_t i = 0; i < block.data->vtx.size(); ++i) {
+        const auto& tx{block.data->vtx.at(i)};
+
+        // Skip duplicate txid coinbase transactions (BIP30).
+        if (IsBIP30Unspendable(block.hash, block.height) && tx->IsCoinBase()) {
+            const CAmount block_subsidy{GetBlockSubsidy(block.height, Params().GetConsensus())};
+            delta.unspendable_amount += block_subsidy;
+            delta.unspendables_bip30 += block_subsidy;
+            continue;
+        }
+
+        for (uint32_t j = 0; j < tx->vout.size(); ++j) {
+            const CTxOut& out{tx->vout[j]};
+            Coin coin{out, block.height, tx->IsCoinBase()};
+            COutPoint outpoint{tx->GetHash(), j};
+
+            // Skip unspendable coins
+            if (coin.out.scriptPubKey.IsUnspendable()) {
+                delta.unspendable_amount += coin.out.nValue;
+                delta.unspendables_scripts += coin.out.nValue;
+                continue;
+            }
+
+            ApplyCoinHash(delta.muhash, outpoint, coin);
+
+            if (tx->IsCoinBase()) {
+                delta.coinbase_amount += coin.out.nValue;
+            } else {
+                delta.new_outputs_ex_coinbase_amount += coin.out.nValue;
+            }
+
+            ++delta.outputs_added;
+            delta.bogo_size_added += GetBogoSize(coin.out.scriptPubKey);
+        }
+
+        // The coinbase tx has no undo data since no former output is spent
+        if (!tx->IsCoinBase()) {
+            const auto& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
+
+            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                Coin coin{tx_undo.vprevout[j]};
+                COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
+
+                RemoveCoinHash(delta.muhash, outpoint, coin);
+
+                delta.prevout_spent_amount += coin.out.nValue;
+
+                ++delta.outputs_removed;
+                delta.bogo_size_removed += GetBogoSize(coin.out.scriptPubKey);
+            }
+        }
+    }
+
+    // Pay for the inverse here, possibly on a sync worker thread, rather than
+    // when the running hash is finalized in CustomAppendPrepared().
+    delta.muhash.Normalize();
+    return delta;
+}
+
+bool CoinStatsIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
 {
     const CAmount block_subsidy{GetBlockSubsidy(block.height, Params().GetConsensus())};
     m_total_subsidy += block_subsidy;
@@ -136,61 +220,19 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
             }
         }
 
-        // Add the new utxos created from the block
-        assert(block.data);
-        for (size_t i = 0; i < block.data->vtx.size(); ++i) {
-            const auto& tx{block.data->vtx.at(i)};
-
-            // Skip duplicate txid coinbase transactions (BIP30).
-            if (IsBIP30Unspendable(block.hash, block.height) && tx->IsCoinBase()) {
-                m_total_unspendable_amount += block_subsidy;
-                m_total_unspendables_bip30 += block_subsidy;
-                continue;
-            }
-
-            for (uint32_t j = 0; j < tx->vout.size(); ++j) {
-                const CTxOut& out{tx->vout[j]};
-                Coin coin{out, block.height, tx->IsCoinBase()};
-                COutPoint outpoint{tx->GetHash(), j};
-
-                // Skip unspendable coins
-                if (coin.out.scriptPubKey.IsUnspendable()) {
-                    m_total_unspendable_amount += coin.out.nValue;
-                    m_total_unspendables_scripts += coin.out.nValue;
-                    continue;
-                }
-
-                ApplyCoinHash(m_muhash, outpoint, coin);
-
-                if (tx->IsCoinBase()) {
-                    m_total_coinbase_amount += coin.out.nValue;
-                } else {
-                    m_total_new_outputs_ex_coinbase_amount += coin.out.nValue;
-                }
-
-                ++m_transaction_output_count;
-                m_total_amount += coin.out.nValue;
-                m_bogo_size += GetBogoSize(coin.out.scriptPubKey);
-            }
-
-            // The coinbase tx has no undo data since no former output is spent
-            if (!tx->IsCoinBase()) {
-                const auto& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
-
-                for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
-                    Coin coin{tx_undo.vprevout[j]};
-                    COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
-
-                    RemoveCoinHash(m_muhash, outpoint, coin);
-
-                    m_total_prevout_spent_amount += coin.out.nValue;
-
-                    --m_transaction_output_count;
-                    m_total_amount -= coin.out.nValue;
-                    m_bogo_size -= GetBogoSize(coin.out.scriptPubKey);
-                }
-            }
-        }
+        const BlockStatsDelta& delta{*Assert(std::any_cast<BlockStatsDelta>(&prepared))};
+        m_muhash *= delta.muhash;
+        m_transaction_output_count += delta.outputs_added;
+        m_transaction_output_count -= delta.outputs_removed;
+        m_bogo_size += delta.bogo_size_added;
+        m_bogo_size -= delta.bogo_size_removed;
+        m_total_amount += delta.coinbase_amount + delta.new_outputs_ex_coinbase_amount - delta.prevout_spent_amount;
+        m_total_unspendable_amount += delta.unspendable_amount;
+        m_total_unspendables_bip30 += delta.unspendables_bip30;
+        m_total_unspendables_scripts += delta.unspendables_scripts;
+        m_total_prevout_spent_amount += delta.prevout_spent_amount;
+        m_total_new_outputs_ex_coinbase_amount += delta.new_outputs_ex_coinbase_amount;
+        m_total_coinbase_amount += delta.coinbase_amount;
     } else {
         // genesis block
         m_total_unspendable_amount += block_subsidy;
@@ -49,7 +49,9 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    std::any CustomPrepareBlock(const interfaces::BlockInfo& block) override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
 
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
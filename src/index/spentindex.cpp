@@ -0,0 +1,111 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/spentindex.h>
+
+#include <common/args.h>
+#include <undo.h>
+#include <util/check.h>
+
+constexpr uint8_t DB_SPENTINDEX{'s'};
+
+std::unique_ptr<SpentIndex> g_spent_index;
+
+namespace {
+
+struct DBSpentKey {
+    COutPoint outpoint;
+
+    explicit DBSpentKey(const COutPoint& outpoint_in) : outpoint(outpoint_in) {}
+
+    SERIALIZE_METHODS(DBSpentKey, obj)
+    {
+        uint8_t prefix{DB_SPENTINDEX};
+        READWRITE(prefix);
+        if (prefix != DB_SPENTINDEX) {
+            throw std::ios_base::failure("Invalid format for spentindex DB key");
+        }
+
+        READWRITE(obj.outpoint);
+    }
+};
+
+} // namespace
+
+/** Access to the spentindex database (indexes/spentindex/) */
+class SpentIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+SpentIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "spentindex", n_cache_size, f_memory, f_wipe)
+{}
+
+SpentIndex::SpentIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "spentindex"), m_db(std::make_unique<SpentIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+SpentIndex::~SpentIndex() = default;
+
+interfaces::Chain::NotifyOptions SpentIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    // Only the values of the spent outputs are stored.
+    options.undo_columns = undo_column::AMOUNTS;
+    return options;
+}
+
+bool SpentIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    // The genesis block has no inputs and no undo data.
+    if (block.height == 0) return true;
+
+    const CBlock& data{*Assert(block.data)};
+    const CBlockUndo& undo{*Assert(block.undo_data)};
+    CDBBatch batch(*m_db);
+    for (size_t i = 1; i < data.vtx.size(); ++i) {
+        const CTransaction& tx{*data.vtx[i]};
+        const CTxUndo& tx_undo{undo.vtxundo.at(i - 1)};
+        for (size_t j = 0; j < tx.vin.size(); ++j) {
+            const SpentIndexValue value{.txid = tx.GetHash(), .input_index = uint32_t(j), .height = block.height, .value = tx_undo.vprevout.at(j).out.nValue};
+            batch.Write(DBSpentKey(tx.vin[j].prevout), value);
+        }
+    }
+    return m_db->WriteBatch(batch);
+}
+
+bool SpentIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    const CBlock& data{*Assert(block.data)};
+    CDBBatch batch(*m_db);
+    for (size_t i = 1; i < data.vtx.size(); ++i) {
+        for (const CTxIn& txin : data.vtx[i]->vin) {
+            batch.Erase(DBSpentKey(txin.prevout));
+        }
+    }
+    return m_db->WriteBatch(batch);
+}
+
+BaseIndex::DB& SpentIndex::GetDB() const { return *m_db; }
+
+std::optional<SpentIndexValue> SpentIndex::FindSpender(const COutPoint& outpoint) const
+{
+    SpentIndexValue value;
+    if (!m_db->Read(DBSpentKey(outpoint), value)) return std::nullopt;
+    return value;
+}
+
+std::vector<std::optional<SpentIndexValue>> SpentIndex::FindSpenders(std::span<const COutPoint> outpoints) const
+{
+    std::vector<DBSpentKey> keys;
+    keys.reserve(outpoints.size());
+    for (const COutPoint& outpoint : outpoints) keys.emplace_back(outpoint);
+    std::vector<std::optional<SpentIndexValue>> values(outpoints.size());
+    m_db->ReadMany(std::span<const DBSpentKey>{keys}, std::span{values});
+    return values;
+}
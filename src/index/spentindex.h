@@ -0,0 +1,77 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SPENTINDEX_H
+#define BITCOIN_INDEX_SPENTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <util/transaction_identifier.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+static constexpr bool DEFAULT_SPENTINDEX{false};
+
+/** The input spending an output in the active chain. */
+struct SpentIndexValue {
+    Txid txid;
+    uint32_t input_index{0};
+    int height{0};
+    //! Value of the spent output, from the block undo data.
+    CAmount value{0};
+
+    SERIALIZE_METHODS(SpentIndexValue, obj)
+    {
+        READWRITE(obj.txid, VARINT(obj.input_index), VARINT_MODE(obj.height, VarIntMode::NONNEGATIVE_SIGNED), VARINT_MODE(obj.value, VarIntMode::NONNEGATIVE_SIGNED));
+    }
+};
+
+/**
+ * SpentIndex is used to look up the transaction that spent an output. The
+ * index is written to a LevelDB database and records, by outpoint, the
+ * spending transaction, the input index and the height of the block.
+ */
+class SpentIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit SpentIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~SpentIndex() override;
+
+    /// Look up the input spending an outpoint. Returns std::nullopt if the
+    /// outpoint is unspent or unknown.
+    std::optional<SpentIndexValue> FindSpender(const COutPoint& outpoint) const;
+
+    /// Look up the inputs spending many outpoints at once.
+    std::vector<std::optional<SpentIndexValue>> FindSpenders(std::span<const COutPoint> outpoints) const;
+};
+
+/// The global spent-output index. May be null.
+extern std::unique_ptr<SpentIndex> g_spent_index;
+
+#endif // BITCOIN_INDEX_SPENTINDEX_H
@@ -6,11 +6,16 @@
 
 #include <clientversion.h>
 #include <common/args.h>
+#include <core_memusage.h>
 #include <index/disktxpos.h>
 #include <logging.h>
+#include <memusage.h>
 #include <node/blockstorage.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <tuple>
+
 constexpr uint8_t DB_TXINDEX{'t'};
 
 std::unique_ptr<TxIndex> g_txindex;
@@ -26,6 +31,9 @@ public:
     /// transaction hash is not indexed.
     bool ReadTxPos(const uint256& txid, CDiskTxPos& pos) const;
 
+    /// Read the disk locations of many transactions at once.
+    std::vector<std::optional<CDiskTxPos>> ReadTxPositions(std::span<const uint256> txids) const;
+
     /// Write a batch of transaction positions to the DB.
     [[nodiscard]] bool WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
 };
@@ -39,6 +47,16 @@ bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
     return Read(std::make_pair(DB_TXINDEX, txid), pos);
 }
 
+std::vector<std::optional<CDiskTxPos>> TxIndex::DB::ReadTxPositions(std::span<const uint256> txids) const
+{
+    std::vector<std::pair<uint8_t, uint256>> keys;
+    keys.reserve(txids.size());
+    for (const uint256& txid : txids) keys.emplace_back(DB_TXINDEX, txid);
+    std::vector<std::optional<CDiskTxPos>> positions(txids.size());
+    ReadMany(std::span<const std::pair<uint8_t, uint256>>{keys}, std::span{positions});
+    return positions;
+}
+
 bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
 {
     CDBBatch batch(*this);
@@ -48,8 +66,8 @@ bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_
     return WriteBatch(batch);
 }
 
-TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
-    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe))
+TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe, size_t max_cache_bytes)
+    : BaseIndex(std::move(chain), "txindex"), m_db(std::make_unique<TxIndex::DB>(n_cache_size, f_memory, f_wipe)), m_max_cache_bytes{max_cache_bytes}
 {}
 
 TxIndex::~TxIndex() = default;
@@ -67,13 +85,75 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    return m_db->WriteTxs(vPos);
+    if (!m_db->WriteTxs(vPos)) return false;
+
+    // Drop cached lookups of these transactions, which may have been found
+    // in another block, only once the new positions are written. Lookups
+    // that started before are not cached, see AddCached().
+    LOCK(m_cache_mutex);
+    ++m_cache_generation;
+    for (const auto& [tx_hash, _] : vPos) {
+        if (auto it{m_cache_map.find(tx_hash)}; it != m_cache_map.end()) {
+            m_cache_usage -= it->second->usage;
+            m_cache.erase(it->second);
+            m_cache_map.erase(it);
+        }
+    }
+    return true;
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
 
+std::optional<TxIndex::CachedTx> TxIndex::GetCached(const uint256& tx_hash) const
+{
+    LOCK(m_cache_mutex);
+    const auto it{m_cache_map.find(tx_hash)};
+    if (it == m_cache_map.end()) return std::nullopt;
+    m_cache.splice(m_cache.begin(), m_cache, it->second);
+    return *it->second;
+}
+
+uint64_t TxIndex::CacheGeneration() const
+{
+    return WITH_LOCK(m_cache_mutex, return m_cache_generation);
+}
+
+void TxIndex::AddCached(CachedTx entry, uint64_t generation) const
+{
+    // The list and map nodes, and the transaction, which is counted in full
+    // even if it is shared with other users.
+    entry.usage = memusage::MallocUsage(sizeof(CachedTx) + 2 * sizeof(void*)) +
+                  memusage::MallocUsage(sizeof(std::pair<const uint256, std::list<CachedTx>::iterator>) + sizeof(void*)) +
+                  RecursiveDynamicUsage(entry.tx);
+    if (entry.usage > m_max_cache_bytes) return;
+    LOCK(m_cache_mutex);
+    if (generation != m_cache_generation || m_cache_map.contains(entry.tx_hash)) return;
+    while (m_cache_usage + entry.usage > m_max_cache_bytes) {
+        m_cache_usage -= m_cache.back().usage;
+        m_cache_map.erase(m_cache.back().tx_hash);
+        m_cache.pop_back();
+    }
+    m_cache_usage += entry.usage;
+    m_cache.push_front(std::move(entry));
+    m_cache_map.emplace(m_cache.front().tx_hash, m_cache.begin());
+}
+
+size_t TxIndex::DynamicMemoryUsage() const
+{
+    LOCK(m_cache_mutex);
+    // Entries include their map nodes, so only the bucket array is added.
+    return m_cache_usage + memusage::MallocUsage(sizeof(void*) * m_cache_map.bucket_count());
+}
+
 bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const
 {
+    if (auto cached{GetCached(tx_hash)}) {
+        block_hash = cached->block_hash;
+        tx = std::move(cached->tx);
+        return true;
+    }
+
+    const uint64_t generation{CacheGeneration()};
     CDiskTxPos postx;
     if (!m_db->ReadTxPos(tx_hash, postx)) {
         return false;
@@ -98,5 +178,81 @@ bool TxIndex::FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRe
         return false;
     }
     block_hash = header.GetHash();
+    AddCached({.tx_hash = tx_hash, .block_hash = block_hash, .tx = tx}, generation);
     return true;
 }
+
+std::vector<std::optional<std::pair<uint256, CTransactionRef>>> TxIndex::FindTxs(std::span<const uint256> tx_hashes) const
+{
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> result(tx_hashes.size());
+    std::vector<size_t> misses;
+    for (size_t i = 0; i < tx_hashes.size(); ++i) {
+        if (auto cached{GetCached(tx_hashes[i])}) {
+            result[i].emplace(cached->block_hash, std::move(cached->tx));
+        } else {
+            misses.push_back(i);
+        }
+    }
+    if (misses.empty()) return result;
+
+    const uint64_t generation{CacheGeneration()};
+    std::vector<uint256> miss_hashes;
+    miss_hashes.reserve(misses.size());
+    for (const size_t i : misses) miss_hashes.push_back(tx_hashes[i]);
+    const std::vector<std::optional<CDiskTxPos>> positions{m_db->ReadTxPositions(miss_hashes)};
+
+    // Read the transactions in file order, opening each block file once and
+    // reading each block header once.
+    std::vector<size_t> order;
+    for (size_t j = 0; j < misses.size(); ++j) {
+        if (positions[j]) order.push_back(j);
+    }
+    std::ranges::sort(order, [&](size_t a, size_t b) {
+        const CDiskTxPos& pos_a{*positions[a]};
+        const CDiskTxPos& pos_b{*positions[b]};
+        return std::tie(pos_a.nFile, pos_a.nPos, pos_a.nTxOffset) < std::tie(pos_b.nFile, pos_b.nPos, pos_b.nTxOffset);
+    });
+
+    for (size_t begin = 0, end; begin < order.size(); begin = end) {
+        const int file_num{positions[order[begin]]->nFile};
+        for (end = begin + 1; end < order.size() && positions[order[end]]->nFile == file_num; ++end) {}
+
+        AutoFile file{m_chainstate->m_blockman.OpenBlockFile(*positions[order[begin]], true)};
+        if (file.IsNull()) {
+            LogError("OpenBlockFile failed");
+            continue;
+        }
+        std::optional<uint32_t> block_pos;
+        uint256 block_hash;
+        //! Position of the first transaction of the block at block_pos.
+        int64_t txs_pos{0};
+        for (size_t k = begin; k < end; ++k) {
+            const CDiskTxPos& pos{*positions[order[k]]};
+            const uint256& tx_hash{miss_hashes[order[k]]};
+            CTransactionRef tx;
+            try {
+                if (block_pos != pos.nPos) {
+                    CBlockHeader header;
+                    file.seek(pos.nPos, SEEK_SET);
+                    file >> header;
+                    block_hash = header.GetHash();
+                    block_pos = pos.nPos;
+                    txs_pos = file.tell();
+                }
+                file.seek(txs_pos + pos.nTxOffset, SEEK_SET);
+                file >> TX_WITH_WITNESS(tx);
+            } catch (const std::exception& e) {
+                LogError("Deserialize or I/O error - %s", e.what());
+                block_pos.reset();
+                continue;
+            }
+            if (tx->GetHash() != tx_hash) {
+                LogError("txid mismatch");
+                continue;
+            }
+            AddCached({.tx_hash = tx_hash, .block_hash = block_hash, .tx = tx}, generation);
+            result[misses[order[k]]].emplace(block_hash, std::move(tx));
+        }
+    }
+    return result;
+}
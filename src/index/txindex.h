@@ -6,8 +6,24 @@
 #define BITCOIN_INDEX_TXINDEX_H
 
 #include <index/base.h>
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/byte_units.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 static constexpr bool DEFAULT_TXINDEX{false};
+//! -txindexcache default (bytes), the memory for recently looked up transactions.
+static constexpr size_t DEFAULT_TXINDEX_TX_CACHE{16_MiB};
 
 /**
  * TxIndex is used to look up transactions included in the blockchain by hash.
@@ -22,16 +38,44 @@ protected:
 private:
     const std::unique_ptr<DB> m_db;
 
+    /** A transaction found in the index, and the hash of its block. */
+    struct CachedTx {
+        uint256 tx_hash;
+        uint256 block_hash;
+        CTransactionRef tx;
+        //! Memory accounted for the entry, including the transaction.
+        size_t usage{0};
+    };
+
+    /**
+     * Recently looked up transactions, most recent first, using at most
+     * m_max_cache_bytes. Entries are dropped when their transaction is
+     * indexed again, e.g. after a reorg, so that the cache never disagrees
+     * with the database.
+     */
+    const size_t m_max_cache_bytes;
+    mutable Mutex m_cache_mutex;
+    mutable std::list<CachedTx> m_cache GUARDED_BY(m_cache_mutex);
+    mutable size_t m_cache_usage GUARDED_BY(m_cache_mutex){0};
+    mutable std::unordered_map<uint256, std::list<CachedTx>::iterator, SaltedTxidHasher> m_cache_map GUARDED_BY(m_cache_mutex);
+    //! Incremented whenever transactions are indexed, to detect lookups racing with it.
+    uint64_t m_cache_generation GUARDED_BY(m_cache_mutex){0};
+
+    std::optional<CachedTx> GetCached(const uint256& tx_hash) const EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
+    uint64_t CacheGeneration() const EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
+    //! Cache a lookup that started at the given generation, unless transactions were indexed since.
+    void AddCached(CachedTx entry, uint64_t generation) const EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
+
     bool AllowPrune() const override { return false; }
 
 protected:
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    bool CustomAppend(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
 
     BaseIndex::DB& GetDB() const override;
 
 public:
     /// Constructs the index, which becomes available to be queried.
-    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+    explicit TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false, size_t max_cache_bytes = DEFAULT_TXINDEX_TX_CACHE);
 
     // Destructor is declared because this class contains a unique_ptr to an incomplete type.
     virtual ~TxIndex() override;
@@ -42,7 +86,17 @@ public:
     /// @param[out]  block_hash  The hash of the block the transaction is found in.
     /// @param[out]  tx  The transaction itself.
     /// @return  true if transaction is found, false otherwise
-    bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const;
+    bool FindTx(const uint256& tx_hash, uint256& block_hash, CTransactionRef& tx) const EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
+
+    /// Look up many transactions by hash. Transactions not in the cache are
+    /// read grouped by block file, in file order.
+    ///
+    /// @return  for each hash, the hash of the block the transaction is found
+    ///          in and the transaction itself, or std::nullopt if not found
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> FindTxs(std::span<const uint256> tx_hashes) const EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
+
+    /// Memory used by the cache of recently looked up transactions.
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!m_cache_mutex);
 };
 
 /// The global transaction index, used in GetTransaction. May be null.
@@ -26,6 +26,7 @@ class CFeeRate;
 class CRPCCommand;
 class CScheduler;
 class Coin;
+class ThreadPool;
 class uint256;
 enum class MemPoolRemovalReason;
 enum class RBFTransactionState;
@@ -162,6 +163,14 @@ public:
     //! or std::nullopt if the block filter for this block couldn't be found.
     virtual std::optional<bool> blockFilterMatchesAny(BlockFilterType filter_type, const uint256& block_hash, const GCSFilter::ElementSet& filter_set) = 0;
 
+    //! Returns, for up to count blocks of the active chain starting at
+    //! block_hash and not beyond the block filter index, the block hash and
+    //! whether any of the elements match the block via a BIP 157 block
+    //! filter. Filters are matched in parallel on pool, if given.
+    //! Returns std::nullopt if block_hash is not in the active chain or the
+    //! block filters for the range couldn't be found.
+    virtual std::optional<std::vector<std::pair<uint256, bool>>> blockFiltersMatchAny(BlockFilterType filter_type, const uint256& block_hash, int count, const GCSFilter::ElementSet& filter_set, ThreadPool* pool = nullptr) = 0;
+
     //! Return whether node has the block and optionally return block metadata
     //! or contents.
     virtual bool findBlock(const uint256& hash, const FoundBlock& block={}) = 0;
@@ -336,6 +345,9 @@ public:
         bool disconnect_data = false;
         //! Include undo data with block disconnected notifications.
         bool disconnect_undo_data = false;
+        //! Mask of undo_column values (see undo.h) needed from undo data read
+        //! from disk. Other fields of the spent coins may be left unset.
+        uint8_t undo_columns = 0xff;
     };
 
     //! Register handler for notifications.
@@ -16,6 +16,12 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+//! -columnarundo default (write block undo data in the columnar format)
+static constexpr bool DEFAULT_COLUMNAR_UNDO{true};
+//! -reindexthreads default (0 = scan block files on the import thread)
+static constexpr int DEFAULT_REINDEX_THREADS{0};
+//! Maximum number of threads scanning block files during -reindex
+static constexpr int MAX_REINDEX_THREADS{16};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -24,8 +30,10 @@ static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
 struct BlockManagerOpts {
     const CChainParams& chainparams;
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
+    bool columnar_undo{DEFAULT_COLUMNAR_UNDO};
     uint64_t prune_target{0};
     bool fast_prune{false};
+    int reindex_threads{DEFAULT_REINDEX_THREADS};
     const fs::path blocks_dir;
     Notifications& notifications;
     DBParams block_tree_db_params;
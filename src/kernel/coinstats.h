@@ -74,6 +74,8 @@ struct CCoinsStats {
 uint64_t GetBogoSize(const CScript& script_pub_key);
 
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
+//! Append the serialization of a coin that HASH_SERIALIZED and MUHASH commit to.
+void ApplyCoinHash(DataStream& ss, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
 std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
@@ -4,9 +4,11 @@
 
 #include <kernel/context.h>
 
+#include <crypto/muhash.h>
 #include <crypto/sha256.h>
 #include <logging.h>
 #include <random.h>
+#include <util/obfuscation.h>
 
 #include <mutex>
 #include <string>
@@ -18,6 +20,8 @@ Context::Context()
     std::call_once(globals_initialized, []() {
         std::string sha256_algo = SHA256AutoDetect();
         LogInfo("Using the '%s' SHA256 implementation\n", sha256_algo);
+        LogInfo("Using the '%s' obfuscation implementation\n", ObfuscationAutoDetect());
+        LogInfo("Using the '%s' MuHash3072 implementation\n", MuHash3072AutoDetect());
         RandomInit();
     });
 }
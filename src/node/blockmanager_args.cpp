@@ -18,6 +18,7 @@ namespace node {
 util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Options& opts)
 {
     if (auto value{args.GetBoolArg("-blocksxor")}) opts.use_xor = *value;
+    if (auto value{args.GetBoolArg("-columnarundo")}) opts.columnar_undo = *value;
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg{args.GetIntArg("-prune", opts.prune_target)};
     if (nPruneArg < 0) {
@@ -35,7 +36,14 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
 
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
 
-    ReadDatabaseArgs(args, opts.block_tree_db_params.options);
+    if (auto value{args.GetIntArg("-reindexthreads")}) {
+        if (*value < 0 || *value > kernel::MAX_REINDEX_THREADS) {
+            return util::Error{strprintf(_("-reindexthreads must be between 0 and %d."), kernel::MAX_REINDEX_THREADS)};
+        }
+        opts.reindex_threads = *value;
+    }
+
+    if (auto result{ReadDatabaseArgs(args, opts.block_tree_db_params.options, "blockindex")}; !result) return util::Error{util::ErrorString(result)};
 
     return {};
 }
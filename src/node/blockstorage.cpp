@@ -6,6 +6,8 @@
 
 #include <arith_uint256.h>
 #include <chain.h>
+#include <common/system.h>
+#include <consensus/consensus.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
 #include <dbwrapper.h>
@@ -30,18 +32,33 @@
 #include <util/batchpriority.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
+#include <util/hasher.h>
 #include <util/obfuscation.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <pos/stake.h>
 
 #include <cstddef>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <map>
 #include <optional>
 #include <unordered_map>
+#include <unordered_set>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace kernel {
 static constexpr uint8_t DB_BLOCK_FILES{'f'};
@@ -78,12 +95,39 @@ bool BlockTreeDB::ReadLastBlockFile(int& nFile)
     return Read(DB_LAST_BLOCK, nFile);
 }
 
+// The block index snapshot id is appended to the DB_LAST_BLOCK value. Readers
+// of the last block file number ignore the trailing bytes, and every block
+// index flush rewrites the value without them (see WriteBatchSync), including
+// flushes by versions that do not know about the snapshot. So any change to
+// the block index after the snapshot was written drops its id.
+bool BlockTreeDB::WriteBlockIndexSnapshotId(const uint256& id)
+{
+    int last_file{0};
+    ReadLastBlockFile(last_file);
+    return Write(DB_LAST_BLOCK, std::make_pair(last_file, id), /*fSync=*/true);
+}
+
+std::optional<uint256> BlockTreeDB::ReadBlockIndexSnapshotId()
+{
+    std::pair<int, uint256> value;
+    if (!Read(DB_LAST_BLOCK, value)) return std::nullopt;
+    return value.second;
+}
+
+bool BlockTreeDB::EraseBlockIndexSnapshotId()
+{
+    int last_file{0};
+    if (!ReadLastBlockFile(last_file)) return true;
+    return Write(DB_LAST_BLOCK, last_file, /*fSync=*/true);
+}
+
 bool BlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*>>& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo)
 {
     CDBBatch batch(*this);
     for (const auto& [file, info] : fileInfo) {
         batch.Write(std::make_pair(DB_BLOCK_FILES, file), *info);
     }
+    // Also drops the block index snapshot id, if any.
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (const CBlockIndex* bi : blockinfo) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, bi->GetBlockHash()), CDiskBlockIndex{bi});
@@ -152,6 +196,51 @@ bool BlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, s
 
 namespace node {
 
+/** A read-only memory mapping of a whole block file. */
+class MappedBlockFile
+{
+public:
+    const int file_num;
+    std::span<const std::byte> data;
+
+    MappedBlockFile(int num, std::span<const std::byte> mapped) : file_num{num}, data{mapped} {}
+    MappedBlockFile(const MappedBlockFile&) = delete;
+    MappedBlockFile& operator=(const MappedBlockFile&) = delete;
+
+    ~MappedBlockFile()
+    {
+#ifndef WIN32
+        munmap(const_cast<std::byte*>(data.data()), data.size());
+#endif
+    }
+
+    /**
+     * Map the file at @p path, or return nullptr if it cannot be mapped. Block
+     * files are not mapped on Windows, nor on 32-bit systems, whose address
+     * space cannot hold many of them.
+     */
+    static std::shared_ptr<const MappedBlockFile> Map(const fs::path& path, int num)
+    {
+#ifdef WIN32
+        return nullptr;
+#else
+        if constexpr (sizeof(void*) < 8) return nullptr;
+        const int fd{open(path.c_str(), O_RDONLY)};
+        if (fd == -1) return nullptr;
+        struct stat st;
+        void* mapped{MAP_FAILED};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            // Blocks are appended to the current file through regular writes,
+            // which a shared mapping observes as they reach the page cache.
+            mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (mapped == MAP_FAILED) return nullptr;
+        return std::make_shared<const MappedBlockFile>(num, std::span{static_cast<const std::byte*>(mapped), size_t(st.st_size)});
+#endif
+    }
+};
+
 bool CBlockIndexWorkComparator::operator()(const CBlockIndex* pa, const CBlockIndex* pb) const
 {
     // First sort by most total work, ...
@@ -201,9 +290,19 @@ const CBlockIndex* BlockManager::LookupBlockIndex(const uint256& hash) const
     return it == m_block_index.end() ? nullptr : &it->second;
 }
 
+const CBlockIndex* BlockManager::LookupBlockIndexShared(const uint256& hash) const NO_THREAD_SAFETY_ANALYSIS
+{
+    // Writers modify the map itself only while holding m_block_index_mutex
+    // exclusively, so a shared lock is enough to search it.
+    std::shared_lock<std::shared_mutex> lock(m_block_index_mutex);
+    BlockMap::const_iterator it = m_block_index.find(hash);
+    return it == m_block_index.end() ? nullptr : &it->second;
+}
+
 CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockIndex*& best_header)
 {
     AssertLockHeld(cs_main);
+    std::unique_lock<std::shared_mutex> index_lock(m_block_index_mutex);
 
     auto [mi, inserted] = m_block_index.try_emplace(block.GetHash(), block);
     if (!inserted) {
@@ -225,6 +324,7 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockInde
     }
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
+    index_lock.unlock();
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
     if (best_header == nullptr || best_header->nChainWork < pindexNew->nChainWork) {
         best_header = pindexNew;
@@ -290,6 +390,10 @@ void BlockManager::FindFilesToPruneManual(
         if (fileinfo.nSize == 0 || fileinfo.nHeightLast > (unsigned)last_block_can_prune || fileinfo.nHeightFirst < (unsigned)min_block_to_prune) {
             continue;
         }
+        if (IsBlockFileMappingInUse(fileNumber)) {
+            LogDebug(BCLog::PRUNE, "Not pruning blk%05u.dat, a block read from it is still in use\n", fileNumber);
+            continue;
+        }
 
         PruneOneBlockFile(fileNumber);
         setFilesToPrune.insert(fileNumber);
@@ -358,6 +462,9 @@ void BlockManager::FindFilesToPrune(
             if (fileinfo.nHeightLast > (unsigned)last_block_can_prune || fileinfo.nHeightFirst < (unsigned)min_block_to_prune) {
                 continue;
             }
+            // A mapping of the file is still referenced by a RawBlockView;
+            // leave the file for a later prune.
+            if (IsBlockFileMappingInUse(fileNumber)) continue;
 
             PruneOneBlockFile(fileNumber);
             // Queue up the files for removal
@@ -378,6 +485,284 @@ void BlockManager::UpdatePruneLock(const std::string& name, const PruneLockInfo&
     m_prune_locks[name] = lock_info;
 }
 
+static constexpr uint32_t BLOCK_INDEX_SNAPSHOT_MAGIC{0x78646962}; // "bidx"
+static constexpr uint32_t BLOCK_INDEX_SNAPSHOT_VERSION{1};
+//! Number of records per independently checksummed and decoded chunk.
+static constexpr uint32_t BLOCK_INDEX_SNAPSHOT_CHUNK_RECORDS{4096};
+
+/** Fixed-size on-disk representation of a block index entry. */
+struct BlockIndexSnapshotRecord {
+    uint256 hash;
+    uint256 prev_hash;
+    uint256 merkle_root;
+    int32_t height{0};
+    int32_t version{0};
+    uint32_t status{0};
+    uint32_t tx_count{0};
+    uint32_t time{0};
+    uint32_t bits{0};
+    uint32_t nonce{0};
+    int32_t file{0};
+    uint32_t data_pos{0};
+    uint32_t undo_pos{0};
+
+    static constexpr size_t SIZE{3 * uint256::size() + 10 * sizeof(uint32_t)};
+
+    SERIALIZE_METHODS(BlockIndexSnapshotRecord, obj)
+    {
+        READWRITE(obj.hash, obj.prev_hash, obj.merkle_root, obj.height, obj.version, obj.status, obj.tx_count,
+                  obj.time, obj.bits, obj.nonce, obj.file, obj.data_pos, obj.undo_pos);
+    }
+};
+
+bool WriteBlockIndexSnapshot(const fs::path& path, const BlockMap& block_index, const BlockIndexSnapshotTag& tag)
+{
+    AssertLockHeld(::cs_main);
+    const fs::path tmp_path{path + ".new"};
+    AutoFile file{fsbridge::fopen(tmp_path, "wb")};
+    if (file.IsNull()) {
+        LogWarning("Failed to open %s for writing", fs::PathToString(tmp_path));
+        return false;
+    }
+    try {
+        file << BLOCK_INDEX_SNAPSHOT_MAGIC << BLOCK_INDEX_SNAPSHOT_VERSION << tag
+             << uint64_t{block_index.size()} << BLOCK_INDEX_SNAPSHOT_CHUNK_RECORDS;
+
+        DataStream chunk;
+        chunk.reserve(BLOCK_INDEX_SNAPSHOT_CHUNK_RECORDS * BlockIndexSnapshotRecord::SIZE);
+        const auto write_chunk{[&] {
+            file << Hash(chunk);
+            file.write(chunk);
+            chunk.clear();
+        }};
+        // Write the entries in height order, so that loading the snapshot
+        // allocates them in that order from the block map's memory pool.
+        std::vector<const CBlockIndex*> sorted;
+        sorted.reserve(block_index.size());
+        for (const auto& [_, index] : block_index) sorted.push_back(&index);
+        std::sort(sorted.begin(), sorted.end(), CBlockIndexHeightOnlyComparator());
+
+        uint32_t records_in_chunk{0};
+        for (const CBlockIndex* pindex : sorted) {
+            const CBlockIndex& index{*pindex};
+            chunk << BlockIndexSnapshotRecord{
+                .hash = index.GetBlockHash(),
+                .prev_hash = index.pprev ? index.pprev->GetBlockHash() : uint256{},
+                .merkle_root = index.hashMerkleRoot,
+                .height = index.nHeight,
+                .version = index.nVersion,
+                .status = index.nStatus,
+                .tx_count = index.nTx,
+                .time = index.nTime,
+                .bits = index.nBits,
+                .nonce = index.nNonce,
+                .file = index.nFile,
+                .data_pos = index.nDataPos,
+                .undo_pos = index.nUndoPos,
+            };
+            if (++records_in_chunk == BLOCK_INDEX_SNAPSHOT_CHUNK_RECORDS) {
+                write_chunk();
+                records_in_chunk = 0;
+            }
+        }
+        if (records_in_chunk > 0) write_chunk();
+
+        if (!file.Commit()) {
+            (void)file.fclose();
+            throw std::runtime_error("Commit failed");
+        }
+        if (file.fclose() != 0) {
+            throw std::runtime_error(strprintf("Error closing %s: %s", fs::PathToString(tmp_path), SysErrorString(errno)));
+        }
+        if (!RenameOver(tmp_path, path)) {
+            throw std::runtime_error("Rename failed");
+        }
+    } catch (const std::exception& e) {
+        LogWarning("Failed to write block index snapshot: %s", e.what());
+        (void)file.fclose();
+        return false;
+    }
+    return true;
+}
+
+bool ReadBlockIndexSnapshot(const fs::path& path, const BlockIndexSnapshotTag& tag, BlockMap& block_index, int num_threads)
+{
+    AssertLockHeld(::cs_main);
+    Assume(block_index.empty());
+
+    std::vector<std::byte> data;
+    {
+        AutoFile file{fsbridge::fopen(path, "rb")};
+        if (file.IsNull()) return false;
+        try {
+            data.resize(fs::file_size(path));
+            file.read(data);
+        } catch (const std::exception& e) {
+            LogWarning("Failed to read block index snapshot %s: %s", fs::PathToString(path), e.what());
+            return false;
+        }
+    }
+
+    SpanReader header{data};
+    uint32_t magic, version, chunk_records;
+    BlockIndexSnapshotTag file_tag;
+    uint64_t count;
+    try {
+        header >> magic >> version >> file_tag >> count >> chunk_records;
+    } catch (const std::ios_base::failure&) {
+        return false;
+    }
+    if (magic != BLOCK_INDEX_SNAPSHOT_MAGIC || version != BLOCK_INDEX_SNAPSHOT_VERSION || chunk_records == 0) return false;
+    if (!(file_tag == tag)) {
+        LogInfo("Block index snapshot does not match the block tree database, ignoring it");
+        return false;
+    }
+    if (count > header.size() / BlockIndexSnapshotRecord::SIZE) return false;
+    const size_t num_chunks{static_cast<size_t>((count + chunk_records - 1) / chunk_records)};
+    if (header.size() != num_chunks * uint256::size() + count * BlockIndexSnapshotRecord::SIZE) return false;
+    const std::span<const std::byte> body{data.end() - header.size(), data.end()};
+    const size_t chunk_size{uint256::size() + size_t{chunk_records} * BlockIndexSnapshotRecord::SIZE};
+
+    ThreadPool pool{"blkidxload"};
+    pool.Start(std::max(num_threads, 1) - 1);
+    // Run fn for every chunk on the pool, including this thread, and report whether all succeeded.
+    const auto for_each_chunk{[&](const auto& fn) {
+        std::vector<std::future<bool>> futures;
+        futures.reserve(num_chunks);
+        for (size_t i{0}; i < num_chunks; ++i) {
+            futures.push_back(pool.Submit([&fn, i] { return fn(i); }));
+        }
+        bool ok{true};
+        for (auto& future : futures) ok &= pool.Wait(future);
+        return ok;
+    }};
+
+    // Verify and decode the chunks.
+    std::vector<std::vector<BlockIndexSnapshotRecord>> chunks(num_chunks);
+    const bool decoded{for_each_chunk([&](size_t i) {
+        const auto chunk{body.subspan(i * chunk_size, std::min(chunk_size, body.size() - i * chunk_size))};
+        const auto records{chunk.subspan(uint256::size())};
+        if (uint256{UCharSpanCast(chunk.first(uint256::size()))} != Hash(records)) return false;
+        SpanReader reader{records};
+        chunks[i].resize(records.size() / BlockIndexSnapshotRecord::SIZE);
+        for (auto& record : chunks[i]) reader >> record;
+        return true;
+    })};
+    if (!decoded) {
+        LogWarning("Block index snapshot %s is corrupt, ignoring it", fs::PathToString(path));
+        return false;
+    }
+
+    // Create the entries. This is the only step that modifies the map and
+    // therefore has to run on a single thread.
+    block_index.reserve(count);
+    std::vector<CBlockIndex*> entries;
+    entries.reserve(count);
+    for (const auto& chunk : chunks) {
+        for (const auto& record : chunk) {
+            const auto [it, inserted]{block_index.try_emplace(record.hash)};
+            if (!inserted) {
+                block_index.clear();
+                return false;
+            }
+            it->second.phashBlock = &it->first;
+            entries.push_back(&it->second);
+        }
+    }
+
+    // Fill in the entries and link them to their parents. Each task writes
+    // only the entries of its own chunk; the caller holds cs_main on behalf of
+    // the workers until all of them are done.
+    const bool linked{for_each_chunk([&](size_t i) NO_THREAD_SAFETY_ANALYSIS {
+        for (size_t j{0}; j < chunks[i].size(); ++j) {
+            const BlockIndexSnapshotRecord& record{chunks[i][j]};
+            CBlockIndex& index{*entries[i * chunk_records + j]};
+            if (!record.prev_hash.IsNull()) {
+                const auto it{block_index.find(record.prev_hash)};
+                if (it == block_index.end()) return false;
+                index.pprev = &it->second;
+            }
+            index.nHeight = record.height;
+            index.nFile = record.file;
+            index.nDataPos = record.data_pos;
+            index.nUndoPos = record.undo_pos;
+            index.nVersion = record.version;
+            index.hashMerkleRoot = record.merkle_root;
+            index.nTime = record.time;
+            index.nBits = record.bits;
+            index.nNonce = record.nonce;
+            index.nStatus = record.status;
+            index.nTx = record.tx_count;
+        }
+        return true;
+    })};
+    if (!linked) {
+        LogWarning("Block index snapshot %s has entries with unknown parents, ignoring it", fs::PathToString(path));
+        block_index.clear();
+        return false;
+    }
+    return true;
+}
+
+bool BlockManager::WriteBlockIndexSnapshot()
+{
+    AssertLockHeld(::cs_main);
+    if (!m_block_index_loaded) {
+        LogDebug(BCLog::BLOCKSTORAGE, "Block index was not fully loaded, not writing a snapshot\n");
+        return false;
+    }
+    if (!m_dirty_blockindex.empty() || !m_dirty_fileinfo.empty()) {
+        LogDebug(BCLog::BLOCKSTORAGE, "Block index has unflushed changes, not writing a snapshot\n");
+        return false;
+    }
+    const uint256 id{GetRandHash()};
+    if (!node::WriteBlockIndexSnapshot(GetBlockIndexSnapshotPath(), m_block_index, GetBlockIndexSnapshotTag(id))) {
+        return false;
+    }
+    return m_block_tree_db->WriteBlockIndexSnapshotId(id);
+}
+
+BlockIndexSnapshotTag BlockManager::GetBlockIndexSnapshotTag(const uint256& id)
+{
+    AssertLockHeld(::cs_main);
+    int last_file{0};
+    m_block_tree_db->ReadLastBlockFile(last_file);
+    CBlockFileInfo info;
+    m_block_tree_db->ReadBlockFileInfo(last_file, info);
+    return {
+        .id = id,
+        .last_file = last_file,
+        .last_file_blocks = info.nBlocks,
+        .last_file_size = info.nSize,
+        .last_file_undo_size = info.nUndoSize,
+    };
+}
+
+bool BlockManager::LoadBlockIndexFromSnapshot()
+{
+    AssertLockHeld(::cs_main);
+    const std::optional<uint256> id{m_block_tree_db->ReadBlockIndexSnapshotId()};
+    if (!id) return false;
+    // The block tree database may change as soon as the node runs, so the
+    // snapshot must not be used again after this startup.
+    if (!m_block_tree_db->EraseBlockIndexSnapshotId()) return false;
+
+    const fs::path path{GetBlockIndexSnapshotPath()};
+    const auto start{SteadyClock::now()};
+    bool loaded;
+    {
+        std::unique_lock<std::shared_mutex> index_lock(m_block_index_mutex);
+        loaded = node::ReadBlockIndexSnapshot(path, GetBlockIndexSnapshotTag(*id), m_block_index, GetNumCores());
+    }
+    if (loaded) {
+        LogInfo("Loaded %d block index entries from %s in %dms", m_block_index.size(), fs::PathToString(path),
+                Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    }
+    std::error_code ec;
+    fs::remove(path, ec);
+    return loaded;
+}
+
 CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
 {
     AssertLockHeld(cs_main);
@@ -386,6 +771,7 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
         return nullptr;
     }
 
+    std::unique_lock<std::shared_mutex> index_lock(m_block_index_mutex);
     const auto [mi, inserted]{m_block_index.try_emplace(hash)};
     CBlockIndex* pindex = &(*mi).second;
     if (inserted) {
@@ -396,7 +782,7 @@ CBlockIndex* BlockManager::InsertBlockIndex(const uint256& hash)
 
 bool BlockManager::LoadBlockIndex(const std::optional<uint256>& snapshot_blockhash)
 {
-    if (!m_block_tree_db->LoadBlockIndexGuts(
+    if (!LoadBlockIndexFromSnapshot() && !m_block_tree_db->LoadBlockIndexGuts(
             GetConsensus(), [this](const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) { return this->InsertBlockIndex(hash); }, m_interrupt)) {
         return false;
     }
@@ -554,6 +940,7 @@ bool BlockManager::LoadBlockIndexDB(const std::optional<uint256>& snapshot_block
     m_block_tree_db->ReadReindexing(fReindexing);
     if (fReindexing) m_blockfiles_indexed = false;
 
+    m_block_index_loaded = true;
     return true;
 }
 
@@ -655,7 +1042,7 @@ CBlockFileInfo* BlockManager::GetBlockFileInfo(size_t n)
     return &m_blockfile_info.at(n);
 }
 
-bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const
+bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index, uint8_t columns) const
 {
     const FlatFilePos pos{WITH_LOCK(::cs_main, return index.GetUndoPos())};
 
@@ -672,7 +1059,7 @@ bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index
         HashVerifier verifier{filein}; // Use HashVerifier, as reserializing may lose data, c.f. commit d3424243
 
         verifier << index.pprev->GetBlockHash();
-        verifier >> blockundo;
+        UnserializeBlockUndo(verifier, blockundo, columns);
 
         uint256 hashChecksum;
         filein >> hashChecksum;
@@ -700,10 +1087,47 @@ bool BlockManager::FlushUndoFile(int block_file, bool finalize)
     return true;
 }
 
+void BlockManager::QueueFinalizeFlush(int file_num, bool finalize_block, bool finalize_undo)
+{
+    AssertLockHeld(cs_LastBlockFile);
+    const FlatFilePos block_pos{file_num, m_blockfile_info[file_num].nSize};
+    const FlatFilePos undo_pos{file_num, m_blockfile_info[file_num].nUndoSize};
+    auto done{m_flush_pool.Submit([this, block_pos, undo_pos, finalize_block, finalize_undo] {
+        if (finalize_block && !m_block_file_seq.Flush(block_pos, /*finalize=*/true)) {
+            m_opts.notifications.flushError(_("Flushing block file to disk failed. This is likely the result of an I/O error."));
+        }
+        if (finalize_undo && !m_undo_file_seq.Flush(undo_pos, /*finalize=*/true)) {
+            m_opts.notifications.flushError(_("Flushing undo file to disk failed. This is likely the result of an I/O error."));
+        }
+    })};
+    LOCK(m_pending_flushes_mutex);
+    m_pending_flushes.push_back({file_num, done.share()});
+}
+
+void BlockManager::WaitForFlushes(std::optional<int> file_num) const
+{
+    std::vector<std::shared_future<void>> waiting;
+    {
+        LOCK(m_pending_flushes_mutex);
+        while (!m_pending_flushes.empty() &&
+               m_pending_flushes.front().done.wait_for(std::chrono::seconds::zero()) == std::future_status::ready) {
+            m_pending_flushes.pop_front();
+        }
+        size_t count{m_pending_flushes.size()};
+        if (file_num) {
+            while (count > 0 && m_pending_flushes[count - 1].file_num != *file_num) --count;
+        }
+        for (size_t i{0}; i < count; ++i) waiting.push_back(m_pending_flushes[i].done);
+    }
+    for (const auto& done : waiting) done.wait();
+}
+
 bool BlockManager::FlushBlockFile(int blockfile_num, bool fFinalize, bool finalize_undo)
 {
     bool success = true;
     LOCK(cs_LastBlockFile);
+    // Files finalized in the background must be durable as well at this point.
+    WaitForFlushes();
 
     if (m_blockfile_info.size() < 1) {
         // Return if we haven't loaded any blockfiles yet. This happens during
@@ -764,6 +1188,13 @@ uint64_t BlockManager::CalculateCurrentUsage()
 
 void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
 {
+    WaitForFlushes();
+    {
+        // Files with mappings in use are not selected for pruning (see
+        // IsBlockFileMappingInUse()), so only idle mappings are dropped here.
+        LOCK(m_mapped_files_mutex);
+        m_mapped_files.remove_if([&](const auto& file) { return setFilesToPrune.contains(file->file_num); });
+    }
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
@@ -848,18 +1279,15 @@ FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int n
         LogDebug(BCLog::BLOCKSTORAGE, "Leaving block file %i: %s (onto %i) (height %i)\n",
                  last_blockfile, m_blockfile_info[last_blockfile].ToString(), nFile, nHeight);
 
-        // Do not propagate the return code. The flush concerns a previous block
-        // and undo file that has already been written to. If a flush fails
-        // here, and we crash, there is no expected additional block data
-        // inconsistency arising from the flush failure here. However, the undo
-        // data may be inconsistent after a crash if the flush is called during
-        // a reindex. A flush error might also leave some of the data files
-        // untrimmed.
-        if (!FlushBlockFile(last_blockfile, /*fFinalize=*/true, finalize_undo)) {
-            LogPrintLevel(BCLog::BLOCKSTORAGE, BCLog::Level::Warning,
-                          "Failed to flush previous block file %05i (finalize=1, finalize_undo=%i) before opening new block file %05i\n",
-                          last_blockfile, finalize_undo, nFile);
-        }
+        // The previous block file will not be appended to anymore, so it is
+        // finalized in the background; FlushBlockFile() waits for it at the
+        // next flush point. The flush concerns a previous block and undo file
+        // that has already been written to. If a flush fails here, and we
+        // crash, there is no expected additional block data inconsistency
+        // arising from the flush failure here. However, the undo data may be
+        // inconsistent after a crash if the flush is called during a reindex.
+        // A flush error might also leave some of the data files untrimmed.
+        QueueFinalizeFlush(last_blockfile, /*finalize_block=*/true, finalize_undo);
         // No undo data yet in the new file, so reset our undo-height tracking.
         m_blockfile_cursors[chain_type] = BlockfileCursor{nFile};
     }
@@ -906,6 +1334,8 @@ void BlockManager::UpdateBlockInfo(const CBlock& block, unsigned int nHeight, co
 bool BlockManager::FindUndoPos(BlockValidationState& state, int nFile, FlatFilePos& pos, unsigned int nAddSize)
 {
     pos.nFile = nFile;
+    // A queued flush may still truncate this undo file to its previous size.
+    WaitForFlushes(nFile);
 
     LOCK(cs_LastBlockFile);
 
@@ -934,7 +1364,13 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     // Write undo information to disk
     if (block.GetUndoPos().IsNull()) {
         FlatFilePos pos;
-        const auto blockundo_size{static_cast<uint32_t>(GetSerializeSize(blockundo))};
+        DataStream undo_data;
+        if (m_opts.columnar_undo) {
+            SerializeColumnarUndo(undo_data, blockundo);
+        } else {
+            undo_data << blockundo;
+        }
+        const auto blockundo_size{static_cast<uint32_t>(undo_data.size())};
         if (!FindUndoPos(state, block.nFile, pos, blockundo_size + UNDO_DATA_DISK_OVERHEAD)) {
             LogError("FindUndoPos failed for %s while writing block undo", pos.ToString());
             return false;
@@ -955,9 +1391,9 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
             {
                 // Calculate checksum
                 HashWriter hasher{};
-                hasher << block.pprev->GetBlockHash() << blockundo;
+                hasher << block.pprev->GetBlockHash() << std::span{undo_data};
                 // Write undo data & checksum
-                fileout << blockundo << hasher.GetHash();
+                fileout << std::span{undo_data} << hasher.GetHash();
             }
             // BufferedWriter will flush pending data to file when fileout goes out of scope.
         }
@@ -974,14 +1410,12 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
         // with the block writes (usually when a synced up node is getting newly mined blocks) -- this case is caught in
         // the FindNextBlockPos function
         if (pos.nFile < cursor.file_num && static_cast<uint32_t>(block.nHeight) == m_blockfile_info[pos.nFile].nHeightLast) {
-            // Do not propagate the return code, a failed flush here should not
-            // be an indication for a failed write. If it were propagated here,
-            // the caller would assume the undo data not to be written, when in
-            // fact it is. Note though, that a failed flush might leave the data
-            // file untrimmed.
-            if (!FlushUndoFile(pos.nFile, true)) {
-                LogPrintLevel(BCLog::BLOCKSTORAGE, BCLog::Level::Warning, "Failed to flush undo file %05i\n", pos.nFile);
-            }
+            // Finalize the undo file in the background. A failed flush is not
+            // an indication for a failed write, the undo data has been written.
+            // Note though, that a failed flush might leave the data file
+            // untrimmed.
+            LOCK(cs_LastBlockFile);
+            QueueFinalizeFlush(pos.nFile, /*finalize_block=*/false, /*finalize_undo=*/true);
         } else if (pos.nFile == cursor.file_num && block.nHeight > cursor.undo_height) {
             cursor.undo_height = block.nHeight;
         }
@@ -1052,6 +1486,79 @@ bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
     return ReadBlock(block, block_pos, index.GetBlockHash());
 }
 
+bool BlockManager::IsBlockFileMappingInUse(int file_num) const
+{
+    LOCK(m_mapped_files_mutex);
+    // References are only taken from the cache while holding the mutex, so a
+    // mapping the cache holds alone cannot be handed out concurrently.
+    return std::ranges::any_of(m_mapped_files, [&](const auto& file) { return file->file_num == file_num && file.use_count() > 1; });
+}
+
+std::shared_ptr<const MappedBlockFile> BlockManager::GetMappedBlockFile(int file_num, uint64_t min_size) const
+{
+    const auto find_cached{[&]() EXCLUSIVE_LOCKS_REQUIRED(m_mapped_files_mutex) -> std::shared_ptr<const MappedBlockFile> {
+        auto it{std::ranges::find_if(m_mapped_files, [&](const auto& file) { return file->file_num == file_num && file->data.size() >= min_size; })};
+        if (it == m_mapped_files.end()) return nullptr;
+        m_mapped_files.splice(m_mapped_files.begin(), m_mapped_files, it);
+        return m_mapped_files.front();
+    }};
+    if (auto file{WITH_LOCK(m_mapped_files_mutex, return find_cached())}) return file;
+
+    // Map the file without holding the mutex, so that reads from other,
+    // already mapped files are not held up.
+    auto file{MappedBlockFile::Map(m_block_file_seq.FileName({file_num, 0}), file_num)};
+    if (!file || file->data.size() < min_size) return nullptr;
+
+    LOCK(m_mapped_files_mutex);
+    // Another thread may have mapped the file in the meantime.
+    if (auto cached{find_cached()}) return cached;
+    m_mapped_files.push_front(file);
+    // Evict the least recently used mappings that no view refers to. Smaller
+    // mappings of a file that has grown are evicted the same way.
+    for (auto it{m_mapped_files.end()}; m_mapped_files.size() > MAX_MAPPED_BLOCK_FILES && it != m_mapped_files.begin();) {
+        --it;
+        if (it->use_count() == 1) it = m_mapped_files.erase(it);
+    }
+    return file;
+}
+
+std::optional<std::span<const std::byte>> BlockManager::ReadMappedBlock(const FlatFilePos& pos, std::shared_ptr<const MappedBlockFile>& file) const
+{
+    // Any mapping covering the header is enough to check it; the block itself
+    // may require a larger one if the file has grown since it was mapped.
+    file = GetMappedBlockFile(pos.nFile, pos.nPos);
+    if (!file) return std::nullopt;
+
+    MessageStartChars blk_start;
+    unsigned int blk_size;
+    SpanReader{file->data.subspan(pos.nPos - STORAGE_HEADER_BYTES, STORAGE_HEADER_BYTES)} >> blk_start >> blk_size;
+    if (blk_start != GetParams().MessageStart() || blk_size > MAX_SIZE) {
+        // Let the regular read path report the error.
+        return std::nullopt;
+    }
+
+    if (file->data.size() < uint64_t{pos.nPos} + blk_size) {
+        file = GetMappedBlockFile(pos.nFile, uint64_t{pos.nPos} + blk_size);
+        if (!file) return std::nullopt;
+    }
+    return file->data.subspan(pos.nPos, blk_size);
+}
+
+std::optional<RawBlockView> BlockManager::ReadRawBlockView(const FlatFilePos& pos) const
+{
+    RawBlockView view;
+    if (!m_obfuscation && pos.nPos >= STORAGE_HEADER_BYTES) {
+        std::shared_ptr<const MappedBlockFile> file;
+        if (const auto mapped{ReadMappedBlock(pos, file)}) {
+            view.m_file = std::move(file);
+            view.m_mapped = *mapped;
+            return view;
+        }
+    }
+    if (!ReadRawBlock(view.m_buffer, pos)) return std::nullopt;
+    return view;
+}
+
 bool BlockManager::ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos& pos) const
 {
     if (pos.nPos < STORAGE_HEADER_BYTES) {
@@ -1061,6 +1568,13 @@ bool BlockManager::ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos
         LogError("Failed for %s while reading raw block storage header", pos.ToString());
         return false;
     }
+    if (!m_obfuscation) {
+        std::shared_ptr<const MappedBlockFile> file;
+        if (const auto mapped{ReadMappedBlock(pos, file)}) {
+            block.assign(mapped->begin(), mapped->end());
+            return true;
+        }
+    }
     AutoFile filein{OpenBlockFile({pos.nFile, pos.nPos - STORAGE_HEADER_BYTES}, /*fReadOnly=*/true)};
     if (filein.IsNull()) {
         LogError("OpenBlockFile failed for %s while reading raw block", pos.ToString());
@@ -1194,6 +1708,7 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
       m_interrupt{interrupt}
 {
     m_block_tree_db = std::make_unique<BlockTreeDB>(m_opts.block_tree_db_params);
+    m_flush_pool.Start(/*num_workers=*/1);
 
     if (m_opts.block_tree_db_params.wipe_data) {
         m_block_tree_db->WriteReindexing(true);
@@ -1222,10 +1737,194 @@ public:
     }
 };
 
+/**
+ * Return the position of the next message start at or after @p pos, or
+ * std::nullopt if there is none before @p file_size.
+ */
+static std::optional<uint64_t> FindMessageStart(AutoFile& file, uint64_t pos, uint64_t file_size, const MessageStartChars& message_start)
+{
+    std::vector<std::byte> buf(1 << 16);
+    while (pos + message_start.size() <= file_size) {
+        file.seek(pos, SEEK_SET);
+        const size_t len{file.detail_fread(buf)};
+        if (len < message_start.size()) break;
+        const std::span<const std::byte> data{buf.data(), len};
+        const auto found{std::ranges::search(data, std::as_bytes(std::span{message_start}))};
+        if (!found.empty()) return pos + (found.begin() - data.begin());
+        // The message start may straddle the end of the chunk.
+        pos += len - (message_start.size() - 1);
+    }
+    return std::nullopt;
+}
+
+std::vector<BlockFileRecord> ScanBlockFile(AutoFile& file, int file_num, const MessageStartChars& message_start, const util::SignalInterrupt& interrupt)
+{
+    std::vector<BlockFileRecord> records;
+    // Same record framing as ChainstateManager::LoadExternalBlockFile(), which
+    // also recovers from garbage between blocks by searching for the magic.
+    // Only the storage and block headers are read: the size in the storage
+    // header is used to seek to the next record.
+    try {
+        file.seek(0, SEEK_END);
+        const uint64_t file_size{uint64_t(file.tell())};
+        uint64_t pos{0};
+        while (!interrupt && pos + STORAGE_HEADER_BYTES <= file_size) {
+            file.seek(pos, SEEK_SET);
+            MessageStartChars buf;
+            unsigned int size;
+            file >> buf >> size;
+            if (buf != message_start || size < 80 || size > MAX_BLOCK_SERIALIZED_SIZE) {
+                const auto next{FindMessageStart(file, pos + 1, file_size, message_start)};
+                // No further block; this happens at the end of every blk?????.dat file.
+                if (!next) break;
+                pos = *next;
+                continue;
+            }
+            const uint64_t block_pos{pos + STORAGE_HEADER_BYTES};
+            // A record cut off by the end of the file ends the scan.
+            if (block_pos + size > file_size) break;
+            CBlockHeader header;
+            file >> header;
+            records.push_back({header.GetHash(), header.hashPrevBlock, FlatFilePos{file_num, static_cast<unsigned int>(block_pos)}});
+            pos = block_pos + size;
+        }
+    } catch (const std::exception& e) {
+        LogDebug(BCLog::REINDEX, "%s: Deserialize or I/O error - %s\n", __func__, e.what());
+    }
+    return records;
+}
+
+/**
+ * Reindex the block files with worker threads scanning the files and reading
+ * the blocks ahead, in parallel. Only the insertion into the block index runs
+ * serially, in an order in which every parent is inserted before its children.
+ *
+ * @returns false if interrupted
+ */
+static bool ReindexBlockFilesParallel(ChainstateManager& chainman, int num_threads)
+{
+    BlockManager& blockman{chainman.m_blockman};
+    const CChainParams& params{chainman.GetParams()};
+
+    int num_files{0};
+    while (fs::exists(blockman.GetBlockPosFilename(FlatFilePos(num_files, 0)))) ++num_files;
+
+    ThreadPool pool{"reindex"};
+    pool.Start(num_threads);
+
+    std::deque<std::future<std::vector<BlockFileRecord>>> scans;
+    int next_scan{0};
+    const auto schedule_scans{[&] {
+        for (; next_scan < num_files && scans.size() <= size_t(num_threads); ++next_scan) {
+            scans.push_back(pool.Submit([&blockman, &params, &chainman, file_num = next_scan] {
+                AutoFile file{blockman.OpenBlockFile(FlatFilePos(file_num, 0), /*fReadOnly=*/true)};
+                if (file.IsNull()) return std::vector<BlockFileRecord>{};
+                return ScanBlockFile(file, file_num, params.MessageStart(), chainman.m_interrupt);
+            }));
+        }
+    }};
+
+    // Blocks whose parent has not been seen yet, by parent hash.
+    std::multimap<uint256, BlockFileRecord> blocks_with_unknown_parent;
+    // Blocks that have been scheduled for insertion in this run.
+    std::unordered_set<uint256, BlockHasher> seen;
+    uint64_t blocks_loaded{0};
+    const auto start{SteadyClock::now()};
+
+    for (int file_num = 0; file_num < num_files; ++file_num) {
+        schedule_scans();
+        const std::vector<BlockFileRecord> records{pool.Wait(scans.front())};
+        scans.pop_front();
+        if (chainman.m_interrupt) return false;
+        LogPrintf("Reindexing block file blk%05u.dat (%u blocks)...\n", (unsigned int)file_num, records.size());
+
+        // Order the blocks so that each one follows its parent, deferring
+        // those whose parent appears later.
+        std::vector<BlockFileRecord> ready;
+        for (const BlockFileRecord& record : records) {
+            if (seen.contains(record.hash)) continue;
+            const bool parent_known{record.hash == params.GetConsensus().hashGenesisBlock || seen.contains(record.prev_hash) ||
+                                    WITH_LOCK(::cs_main, return blockman.LookupBlockIndex(record.prev_hash) != nullptr)};
+            if (!parent_known) {
+                LogDebug(BCLog::REINDEX, "%s: Out of order block %s, parent %s not known\n", __func__, record.hash.ToString(), record.prev_hash.ToString());
+                blocks_with_unknown_parent.emplace(record.prev_hash, record);
+                continue;
+            }
+            std::deque<BlockFileRecord> queue{record};
+            while (!queue.empty()) {
+                const BlockFileRecord next{queue.front()};
+                queue.pop_front();
+                if (!seen.insert(next.hash).second) continue;
+                ready.push_back(next);
+                auto range{blocks_with_unknown_parent.equal_range(next.hash)};
+                for (auto it{range.first}; it != range.second; ++it) queue.push_back(it->second);
+                blocks_with_unknown_parent.erase(range.first, range.second);
+            }
+        }
+
+        // Read and deserialize the blocks ahead on the workers, and insert
+        // them in order on this thread.
+        std::deque<std::future<std::shared_ptr<CBlock>>> reads;
+        size_t next_read{0};
+        for (const BlockFileRecord& record : ready) {
+            for (; next_read < ready.size() && reads.size() <= 2 * size_t(num_threads); ++next_read) {
+                reads.push_back(pool.Submit([&blockman, rec = ready[next_read]] {
+                    auto block{std::make_shared<CBlock>()};
+                    if (!blockman.ReadBlock(*block, rec.pos, rec.hash)) block.reset();
+                    return block;
+                }));
+            }
+            const std::shared_ptr<CBlock> block{pool.Wait(reads.front())};
+            reads.pop_front();
+            if (chainman.m_interrupt) return false;
+            if (!block) continue;
+
+            {
+                LOCK(::cs_main);
+                const CBlockIndex* pindex{blockman.LookupBlockIndex(record.hash)};
+                if (pindex && (pindex->nStatus & BLOCK_HAVE_DATA)) {
+                    if (record.hash != params.GetConsensus().hashGenesisBlock && pindex->nHeight % 1000 == 0) {
+                        LogDebug(BCLog::REINDEX, "Block Import: already had block %s at height %d\n", record.hash.ToString(), pindex->nHeight);
+                    }
+                    continue;
+                }
+                BlockValidationState state;
+                if (chainman.AcceptBlock(block, state, nullptr, true, &record.pos, nullptr, true)) {
+                    ++blocks_loaded;
+                } else if (state.IsError()) {
+                    break;
+                }
+            }
+
+            // Activate the genesis block so normal node progress can continue
+            if (record.hash == params.GetConsensus().hashGenesisBlock) {
+                for (Chainstate* chainstate : WITH_LOCK(::cs_main, return chainman.GetAll())) {
+                    BlockValidationState state;
+                    if (!chainstate->ActivateBestChain(state, nullptr)) break;
+                }
+            }
+        }
+    }
+    LogPrintf("Loaded %i blocks from %i block files in %dms\n", blocks_loaded, num_files, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+    return true;
+}
+
 void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_paths)
 {
     ImportingNow imp{chainman.m_blockman.m_importing};
 
+    // -reindex with worker threads
+    if (!chainman.m_blockman.m_blockfiles_indexed && chainman.m_blockman.GetReindexThreads() > 0) {
+        if (!ReindexBlockFilesParallel(chainman, chainman.m_blockman.GetReindexThreads())) {
+            LogPrintf("Interrupt requested. Exit %s\n", __func__);
+            return;
+        }
+        WITH_LOCK(::cs_main, chainman.m_blockman.m_block_tree_db->WriteReindexing(false));
+        chainman.m_blockman.m_blockfiles_indexed = true;
+        LogPrintf("Reindexing finished\n");
+        chainman.ActiveChainstate().LoadGenesisBlock();
+    }
+
     // -reindex
     if (!chainman.m_blockman.m_blockfiles_indexed) {
         int nFile = 0;
@@ -15,20 +15,26 @@
 #include <kernel/messagestartchars.h>
 #include <primitives/block.h>
 #include <streams.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
 #include <uint256.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/threadpool.h>
 
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <future>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
+#include <shared_mutex>
 #include <span>
 #include <string>
 #include <unordered_map>
@@ -61,6 +67,9 @@ public:
     bool ReadFlag(const std::string& name, bool& fValue);
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, const util::SignalInterrupt& interrupt)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    bool WriteBlockIndexSnapshotId(const uint256& id);
+    std::optional<uint256> ReadBlockIndexSnapshotId();
+    bool EraseBlockIndexSnapshotId();
 };
 } // namespace kernel
 
@@ -74,6 +83,9 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 /** The maximum size of a blk?????.dat file (since 0.8) */
 static const unsigned int MAX_BLOCKFILE_SIZE = 0x8000000; // 128 MiB
 
+/** The maximum number of blk?????.dat files kept memory-mapped for reading blocks */
+static constexpr size_t MAX_MAPPED_BLOCK_FILES{64};
+
 /** Size of header written by WriteBlock before a serialized CBlock (8 bytes) */
 static constexpr uint32_t STORAGE_HEADER_BYTES{std::tuple_size_v<MessageStartChars> + sizeof(unsigned int)};
 
@@ -84,7 +96,20 @@ static constexpr uint32_t UNDO_DATA_DISK_OVERHEAD{STORAGE_HEADER_BYTES + uint256
 // we ever switch to another associative container, we need to either use a
 // container that has stable addressing (true of all std associative
 // containers), or make the key a `std::unique_ptr<CBlockIndex>`
-using BlockMap = std::unordered_map<uint256, CBlockIndex, BlockHasher>;
+/**
+ * Entries are allocated from a pool of large chunks, so that entries that are
+ * added together (e.g. in height order when loading a block index snapshot or
+ * syncing headers) are adjacent in memory and walks along pprev and pskip
+ * touch few cache lines. See CCoinsMap for the node size overhead.
+ */
+using BlockMap = std::unordered_map<uint256,
+                                    CBlockIndex,
+                                    BlockHasher,
+                                    std::equal_to<uint256>,
+                                    PoolAllocator<std::pair<const uint256, CBlockIndex>,
+                                                  sizeof(std::pair<const uint256, CBlockIndex>) + sizeof(void*) * 4>>;
+
+using BlockMapMemoryResource = BlockMap::allocator_type::ResourceType;
 
 struct CBlockIndexWorkComparator {
     bool operator()(const CBlockIndex* pa, const CBlockIndex* pb) const;
@@ -127,6 +152,65 @@ struct BlockfileCursor {
 
 std::ostream& operator<<(std::ostream& os, const BlockfileCursor& cursor);
 
+/**
+ * Identifies the block tree database state that a block index snapshot was
+ * written for. The id is also stored in the database and erased when the
+ * snapshot is loaded, so that the snapshot is only used once, right after
+ * the clean shutdown that wrote it. The block file statistics additionally
+ * guard against the database being changed by software unaware of the id.
+ */
+struct BlockIndexSnapshotTag {
+    uint256 id;
+    int32_t last_file{0};
+    uint32_t last_file_blocks{0};
+    uint32_t last_file_size{0};
+    uint32_t last_file_undo_size{0};
+
+    SERIALIZE_METHODS(BlockIndexSnapshotTag, obj) { READWRITE(obj.id, obj.last_file, obj.last_file_blocks, obj.last_file_size, obj.last_file_undo_size); }
+    friend bool operator==(const BlockIndexSnapshotTag&, const BlockIndexSnapshotTag&) = default;
+};
+
+/**
+ * Write the persisted fields of all block index entries to a compact file
+ * of fixed-size records in height order, split into checksummed chunks that
+ * can be decoded independently.
+ */
+bool WriteBlockIndexSnapshot(const fs::path& path, const BlockMap& block_index, const BlockIndexSnapshotTag& tag)
+    EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+/**
+ * Load a block index snapshot into an empty @p block_index, decoding the
+ * chunks and linking the entries on @p num_threads worker threads. Only the
+ * fields that LoadBlockIndexGuts() loads are restored. Returns false, leaving
+ * @p block_index empty, if the file is missing, corrupt or not for @p tag.
+ */
+bool ReadBlockIndexSnapshot(const fs::path& path, const BlockIndexSnapshotTag& tag, BlockMap& block_index, int num_threads)
+    EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+class MappedBlockFile;
+
+/**
+ * Serialized block data returned by BlockManager::ReadRawBlockView().
+ *
+ * Points directly into a memory-mapped block file when the block files are
+ * not obfuscated (-blocksxor=0) on 64-bit systems other than Windows, and
+ * owns a de-obfuscated copy of the data otherwise. The mapping stays valid
+ * for the lifetime of the view: it is not evicted from the cache and its
+ * file is not pruned while a view refers to it.
+ */
+class RawBlockView
+{
+    std::shared_ptr<const MappedBlockFile> m_file;
+    std::span<const std::byte> m_mapped;
+    std::vector<std::byte> m_buffer;
+
+    friend class BlockManager;
+
+public:
+    std::span<const std::byte> data() const { return m_file ? m_mapped : std::span<const std::byte>{m_buffer}; }
+    //! Whether the data is read directly from a memory-mapped file, without a copy.
+    bool IsMapped() const { return m_file != nullptr; }
+};
 
 /**
  * Maintains a tree of blocks (stored in `m_block_index`) which is consulted
@@ -143,6 +227,10 @@ class BlockManager
 private:
     const CChainParams& GetParams() const { return m_opts.chainparams; }
     const Consensus::Params& GetConsensus() const { return m_opts.chainparams.GetConsensus(); }
+    //! Load the block index from a snapshot written at the last shutdown, if it is still valid.
+    bool LoadBlockIndexFromSnapshot() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    BlockIndexSnapshotTag GetBlockIndexSnapshotTag(const uint256& id) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     /**
      * Load the blocktree off disk and into memory. Populate certain metadata
      * per index entry (nStatus, nChainWork, nTimeMax, etc.) as well as peripheral
@@ -157,6 +245,20 @@ private:
     /** Return false if undo file flushing fails. */
     [[nodiscard]] bool FlushUndoFile(int block_file, bool finalize = false);
 
+    /**
+     * Truncate and fsync a block file and/or its undo file that will not be
+     * appended to anymore on the background flush thread, using their current
+     * sizes. Failures are reported through the flushError notification.
+     */
+    void QueueFinalizeFlush(int file_num, bool finalize_block, bool finalize_undo) EXCLUSIVE_LOCKS_REQUIRED(cs_LastBlockFile, !m_pending_flushes_mutex);
+
+    /**
+     * Wait for queued background flushes to complete. Flushes complete in the
+     * order they were queued, so this waits for all of them up to the last one
+     * for @p file_num, or for all of them if no file is given.
+     */
+    void WaitForFlushes(std::optional<int> file_num = std::nullopt) const EXCLUSIVE_LOCKS_REQUIRED(!m_pending_flushes_mutex);
+
     /**
      * Helper function performing various preparations before a block can be saved to disk:
      * Returns the correct position for the block to be saved, which may be in the current or a new
@@ -177,7 +279,7 @@ private:
         std::set<int>& setFilesToPrune,
         int nManualPruneHeight,
         const Chainstate& chain,
-        ChainstateManager& chainman);
+        ChainstateManager& chainman) EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
 
     /**
      * Prune block and undo files (blk???.dat and rev???.dat) so that the disk space used is less than a user-defined target.
@@ -199,7 +301,7 @@ private:
         std::set<int>& setFilesToPrune,
         int last_prune,
         const Chainstate& chain,
-        ChainstateManager& chainman);
+        ChainstateManager& chainman) EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
 
     RecursiveMutex cs_LastBlockFile;
     std::vector<CBlockFileInfo> m_blockfile_info;
@@ -237,12 +339,36 @@ private:
 
     const Obfuscation m_obfuscation;
 
+    /** Recently read block files that are memory-mapped, most recently used first. */
+    mutable Mutex m_mapped_files_mutex;
+    mutable std::list<std::shared_ptr<const MappedBlockFile>> m_mapped_files GUARDED_BY(m_mapped_files_mutex);
+
+    /**
+     * Return a mapping of the given block file that covers at least @p min_size
+     * bytes, or nullptr if the file cannot be mapped.
+     */
+    std::shared_ptr<const MappedBlockFile> GetMappedBlockFile(int file_num, uint64_t min_size) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+
+    /** Locate the block at @p pos in a mapped block file and check its storage header. */
+    std::optional<std::span<const std::byte>> ReadMappedBlock(const FlatFilePos& pos, std::shared_ptr<const MappedBlockFile>& file) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+
+    /** Whether a RawBlockView still refers to a mapping of the given block file, which must then not be pruned. */
+    bool IsBlockFileMappingInUse(int file_num) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+
     /** Dirty block index entries. */
     std::set<CBlockIndex*> m_dirty_blockindex;
 
     /** Dirty block file entries. */
     std::set<int> m_dirty_fileinfo;
 
+    /**
+     * Whether LoadBlockIndexDB() completed. An interrupted or failed load
+     * leaves a partial block index that must not be saved as a snapshot.
+     */
+    bool m_block_index_loaded GUARDED_BY(::cs_main){false};
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -258,6 +384,16 @@ private:
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
 
+    struct PendingFlush {
+        int file_num;
+        std::shared_future<void> done;
+    };
+    mutable Mutex m_pending_flushes_mutex;
+    mutable std::deque<PendingFlush> m_pending_flushes GUARDED_BY(m_pending_flushes_mutex);
+    //! Runs the queued flushes on a single thread, in order. Declared after
+    //! everything the flushes use, so that it is stopped first on destruction.
+    ThreadPool m_flush_pool{"blkflush"};
+
 public:
     using Options = kernel::BlockManagerOpts;
 
@@ -274,7 +410,16 @@ public:
      */
     std::atomic_bool m_blockfiles_indexed{true};
 
-    BlockMap m_block_index GUARDED_BY(cs_main);
+    //! Backing memory for m_block_index. Must outlive it.
+    BlockMapMemoryResource m_block_index_memory_resource;
+    BlockMap m_block_index GUARDED_BY(cs_main){0, BlockHasher{}, BlockMap::key_equal{}, &m_block_index_memory_resource};
+
+    /**
+     * Held exclusively (in addition to cs_main) while entries are inserted into
+     * m_block_index and linked into the tree, so that LookupBlockIndexShared()
+     * can search the map without taking cs_main.
+     */
+    mutable std::shared_mutex m_block_index_mutex;
 
     /**
      * The height of the base block of an assumeutxo snapshot, if one is in use.
@@ -301,6 +446,14 @@ public:
     std::unique_ptr<BlockTreeDB> m_block_tree_db GUARDED_BY(::cs_main);
 
     bool WriteBlockIndexDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    /**
+     * Write a block index snapshot for the next startup. Must be called at
+     * shutdown after the last flush, so that it matches the block tree
+     * database. Does nothing unless the block index was fully loaded.
+     */
+    bool WriteBlockIndexSnapshot() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    //! Path of the block index snapshot file.
+    fs::path GetBlockIndexSnapshotPath() const { return m_opts.blocks_dir / "blockindex.dat"; }
     bool LoadBlockIndexDB(const std::optional<uint256>& snapshot_blockhash)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
@@ -320,6 +473,16 @@ public:
 
     CBlockIndex* LookupBlockIndex(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     const CBlockIndex* LookupBlockIndex(const uint256& hash) const EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    /**
+     * Look up a block index entry without holding cs_main.
+     *
+     * Entries are never removed while the node is running, so the result stays
+     * valid. Without cs_main, only the fields that are fixed once the entry is
+     * linked into the tree may be read: the block hash, the header fields,
+     * pprev, nHeight and the skip pointer. Validation state such as nStatus,
+     * nChainWork or the file positions still requires cs_main.
+     */
+    const CBlockIndex* LookupBlockIndexShared(const uint256& hash) const;
 
     /** Get block file info entry for one block file */
     CBlockFileInfo* GetBlockFileInfo(size_t n);
@@ -350,6 +513,8 @@ public:
 
     /** Attempt to stay below this number of bytes of block files. */
     [[nodiscard]] uint64_t GetPruneTarget() const { return m_opts.prune_target; }
+    //! Number of threads scanning block files during -reindex, or 0 to scan them on the import thread
+    [[nodiscard]] int GetReindexThreads() const { return m_opts.reindex_threads; }
     static constexpr auto PRUNE_TARGET_MANUAL{std::numeric_limits<uint64_t>::max()};
 
     [[nodiscard]] bool LoadingBlocks() const { return m_importing || !m_blockfiles_indexed; }
@@ -408,18 +573,46 @@ public:
     /**
      *  Actually unlink the specified files
      */
-    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
+    void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
 
     /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
-    bool ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos& pos) const;
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+    bool ReadBlock(CBlock& block, const CBlockIndex& index) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+    bool ReadRawBlock(std::vector<std::byte>& block, const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
+    /**
+     * Read a serialized block, avoiding a copy where possible. Unobfuscated
+     * block files are memory-mapped (up to MAX_MAPPED_BLOCK_FILES at a time,
+     * plus those still in use), so repeated reads do not need to open, seek
+     * and read the file.
+     */
+    std::optional<RawBlockView> ReadRawBlockView(const FlatFilePos& pos) const EXCLUSIVE_LOCKS_REQUIRED(!m_mapped_files_mutex);
 
-    bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
+    /**
+     * Read the undo data of a block. `columns` is a mask of undo_column values
+     * (see undo.h); fields outside it may be left unset for undo data written
+     * in the columnar format.
+     */
+    bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index, uint8_t columns = 0xff) const;
 
     void CleanupBlockRevFiles() const;
 };
 
+/** A block located in a block file while reindexing. */
+struct BlockFileRecord {
+    uint256 hash;
+    uint256 prev_hash;
+    FlatFilePos pos;
+};
+
+/**
+ * Locate the blocks in a block file and hash their headers. Only the storage
+ * and block headers are read; the block contents are skipped by seeking past
+ * them. Returns the blocks in file order, or the blocks found so far if
+ * interrupted.
+ */
+std::vector<BlockFileRecord> ScanBlockFile(AutoFile& file, int file_num, const MessageStartChars& message_start, const util::SignalInterrupt& interrupt);
+
 // Calls ActivateBestChain() even if no blocks are imported.
 void ImportBlocks(ChainstateManager& chainman, std::span<const fs::path> import_paths);
 } // namespace node
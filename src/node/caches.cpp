@@ -5,6 +5,8 @@
 #include <node/caches.h>
 
 #include <common/args.h>
+#include <index/addressindex.h>
+#include <index/spentindex.h>
 #include <index/txindex.h>
 #include <kernel/caches.h>
 #include <logging.h>
@@ -17,6 +19,10 @@
 // a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
 //! Max memory allocated to tx index DB specific cache in bytes.
 static constexpr size_t MAX_TX_INDEX_CACHE{1024_MiB};
+//! Max memory allocated to address index DB specific cache in bytes.
+static constexpr size_t MAX_ADDRESS_INDEX_CACHE{1024_MiB};
+//! Max memory allocated to spent-output index DB specific cache in bytes.
+static constexpr size_t MAX_SPENT_INDEX_CACHE{1024_MiB};
 //! Max memory allocated to all block filter index caches combined in bytes.
 static constexpr size_t MAX_FILTER_INDEX_CACHE{1024_MiB};
 //! Maximum dbcache size on 32-bit systems.
@@ -37,6 +43,16 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
     IndexCacheSizes index_sizes;
     index_sizes.tx_index = std::min(total_cache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? MAX_TX_INDEX_CACHE : 0);
     total_cache -= index_sizes.tx_index;
+    if (args.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
+        // Convert -txindexcache from MiB units to bytes, capped like the index database cache.
+        const uint64_t txs_cache_bytes{SaturatingLeftShift<uint64_t>(std::max<int64_t>(args.GetIntArg("-txindexcache", DEFAULT_TXINDEX_TX_CACHE >> 20), 0), 20)};
+        index_sizes.tx_index_txs = std::min<uint64_t>({total_cache / 8, txs_cache_bytes, MAX_TX_INDEX_CACHE});
+    }
+    total_cache -= index_sizes.tx_index_txs;
+    index_sizes.address_index = std::min(total_cache / 8, args.GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) ? MAX_ADDRESS_INDEX_CACHE : 0);
+    total_cache -= index_sizes.address_index;
+    index_sizes.spent_index = std::min(total_cache / 8, args.GetBoolArg("-spentindex", DEFAULT_SPENTINDEX) ? MAX_SPENT_INDEX_CACHE : 0);
+    total_cache -= index_sizes.spent_index;
     if (n_indexes > 0) {
         size_t max_cache = std::min(total_cache / 8, MAX_FILTER_INDEX_CACHE);
         index_sizes.filter_index = max_cache / n_indexes;
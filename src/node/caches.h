@@ -20,6 +20,10 @@ static constexpr size_t DEFAULT_DB_CACHE{DEFAULT_KERNEL_CACHE};
 namespace node {
 struct IndexCacheSizes {
     size_t tx_index{0};
+    //! Recently looked up transactions of the transaction index (-txindexcache).
+    size_t tx_index_txs{0};
+    size_t address_index{0};
+    size_t spent_index{0};
     size_t filter_index{0};
 };
 struct CacheSizes {
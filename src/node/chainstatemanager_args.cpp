@@ -47,7 +47,7 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, ChainstateManage
 
     if (auto value{args.GetIntArg("-maxtipage")}) opts.max_tip_age = std::chrono::seconds{*value};
 
-    ReadDatabaseArgs(args, opts.coins_db);
+    if (auto result{ReadDatabaseArgs(args, opts.coins_db, "chainstate")}; !result) return util::Error{util::ErrorString(result)};
     ReadCoinsViewArgs(args, opts.coins_view);
 
     int script_threads = args.GetIntArg("-par", DEFAULT_SCRIPTCHECK_THREADS);
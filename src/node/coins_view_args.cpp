@@ -7,10 +7,13 @@
 #include <common/args.h>
 #include <txdb.h>
 
+#include <algorithm>
+
 namespace node {
 void ReadCoinsViewArgs(const ArgsManager& args, CoinsViewOptions& options)
 {
     if (auto value = args.GetIntArg("-dbbatchsize")) options.batch_write_bytes = *value;
     if (auto value = args.GetIntArg("-dbcrashratio")) options.simulate_crash_ratio = *value;
+    if (auto value = args.GetIntArg("-sharedcoinscache")) options.shared_cache_bytes = size_t(std::max<int64_t>(*value, 0)) << 20;
 }
 } // namespace node
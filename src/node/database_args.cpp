@@ -6,13 +6,73 @@
 
 #include <common/args.h>
 #include <dbwrapper.h>
+#include <tinyformat.h>
+#include <util/strencodings.h>
+#include <util/translation.h>
+
+#include <optional>
+#include <string>
 
 namespace node {
-void ReadDatabaseArgs(const ArgsManager& args, DBOptions& options)
+namespace {
+/** Defaults for databases whose access pattern differs from the DBOptions defaults. */
+void ApplyDatabaseProfile(std::string_view database, DBOptions& options)
+{
+    if (database == "blockindex") {
+        // Loaded by iterating over all entries at startup, bloom filters are
+        // not used.
+        options.bloom_bits_per_key = 0;
+    } else if (database == "addressindex") {
+        // Range scans only.
+        options.bloom_bits_per_key = 0;
+        options.block_size = 16 << 10;
+    } else if (database == "spentindex") {
+        // Point lookups at a high rate, many of them for unspent (missing) outpoints.
+        options.bloom_bits_per_key = 14;
+    }
+}
+
+/** Get the value of a -db* option for a database, see ReadDatabaseArgs(). */
+std::optional<std::string> GetDatabaseArg(const ArgsManager& args, const std::string& arg, std::string_view database)
+{
+    std::optional<std::string> value, database_value;
+    for (const std::string& entry : args.GetArgs(arg)) {
+        const size_t separator{entry.find(':')};
+        if (separator == std::string::npos) {
+            value = entry;
+        } else if (!database.empty() && std::string_view{entry}.substr(0, separator) == database) {
+            database_value = entry.substr(separator + 1);
+        }
+    }
+    return database_value ? database_value : value;
+}
+
+/** Read an integer -db* option for a database into out, multiplied by unit. */
+template <typename T>
+util::Result<void> ReadDatabaseIntArg(const ArgsManager& args, const std::string& arg, std::string_view database, int64_t min, int64_t max, T& out, int64_t unit = 1)
+{
+    const auto value{GetDatabaseArg(args, arg, database)};
+    if (!value) return {};
+    const auto parsed{ToIntegral<int64_t>(*value)};
+    if (!parsed || *parsed < min || *parsed > max) {
+        return util::Error{strprintf(_("%s must be between %d and %d."), arg, min, max)};
+    }
+    out = static_cast<T>(*parsed * unit);
+    return {};
+}
+} // namespace
+
+util::Result<void> ReadDatabaseArgs(const ArgsManager& args, DBOptions& options, std::string_view database)
 {
-    // Settings here apply to all databases (chainstate, blocks, and index
-    // databases), but it'd be easy to parse database-specific options by adding
-    // a database_type string or enum parameter to this function.
+    ApplyDatabaseProfile(database, options);
+
     if (auto value = args.GetBoolArg("-forcecompactdb")) options.force_compact = *value;
+
+    if (auto result{ReadDatabaseIntArg(args, "-dbbloombits", database, 0, 32, options.bloom_bits_per_key)}; !result) return result;
+    if (auto result{ReadDatabaseIntArg(args, "-dbblocksize", database, 1, 1024, options.block_size, 1 << 10)}; !result) return result;
+    if (auto result{ReadDatabaseIntArg(args, "-dbmaxfilesize", database, 2, 1024, options.max_file_size, 1 << 20)}; !result) return result;
+    if (auto result{ReadDatabaseIntArg(args, "-dbblockcachepercent", database, 0, 100, options.block_cache_percent)}; !result) return result;
+    if (auto result{ReadDatabaseIntArg(args, "-dbbackgroundcompaction", database, 0, 1, options.background_compaction)}; !result) return result;
+    return {};
 }
 } // namespace node
@@ -5,11 +5,22 @@
 #ifndef BITCOIN_NODE_DATABASE_ARGS_H
 #define BITCOIN_NODE_DATABASE_ARGS_H
 
+#include <util/result.h>
+
+#include <string_view>
+
 class ArgsManager;
 struct DBOptions;
 
 namespace node {
-void ReadDatabaseArgs(const ArgsManager& args, DBOptions& options);
+/**
+ * Apply the built-in performance profile of a database and the -db* options
+ * to options. The database names are "chainstate", "blockindex" and, for
+ * indexes, the name of their directory under indexes/ (e.g. "txindex").
+ * Options given as "<database>:<value>" apply to that database only, and
+ * take precedence over options without a database name.
+ */
+util::Result<void> ReadDatabaseArgs(const ArgsManager& args, DBOptions& options, std::string_view database = {});
 } // namespace node
 
 #endif // BITCOIN_NODE_DATABASE_ARGS_H
@@ -64,10 +64,12 @@
 
 #include <bitcoin-build-config.h> // IWYU pragma: keep
 
+#include <algorithm>
 #include <any>
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include <boost/signals2/signal.hpp>
 
@@ -545,8 +547,8 @@ public:
     explicit ChainImpl(NodeContext& node) : m_node(node) {}
     std::optional<int> getHeight() override
     {
-        const int height{WITH_LOCK(::cs_main, return chainman().ActiveChain().Height())};
-        return height >= 0 ? std::optional{height} : std::nullopt;
+        const auto tip{chainman().ActiveTipSnapshot()};
+        return tip ? std::optional{tip->height} : std::nullopt;
     }
     uint256 getBlockHash(int height) override
     {
@@ -592,6 +594,31 @@ public:
         if (index == nullptr || !block_filter_index->LookupFilter(index, filter)) return std::nullopt;
         return filter.GetFilter().MatchAny(filter_set);
     }
+    std::optional<std::vector<std::pair<uint256, bool>>> blockFiltersMatchAny(BlockFilterType filter_type, const uint256& block_hash, int count, const GCSFilter::ElementSet& filter_set, ThreadPool* pool) override
+    {
+        const BlockFilterIndex* block_filter_index{GetBlockFilterIndex(filter_type)};
+        if (!block_filter_index || count <= 0) return std::nullopt;
+
+        // Blocks the index has not caught up with yet have no filters.
+        const int index_height{block_filter_index->GetSummary().best_block_height};
+        const CBlockIndex* start_index;
+        const CBlockIndex* stop_index;
+        {
+            LOCK(::cs_main);
+            const CChain& active_chain{chainman().ActiveChain()};
+            start_index = chainman().m_blockman.LookupBlockIndex(block_hash);
+            if (!start_index || !active_chain.Contains(start_index) || start_index->nHeight > index_height) return std::nullopt;
+            stop_index = active_chain[std::min({start_index->nHeight + count - 1, active_chain.Height(), index_height})];
+        }
+        std::vector<BlockFilter> filters;
+        if (!block_filter_index->LookupFilterRange(start_index->nHeight, stop_index, filters)) return std::nullopt;
+
+        std::vector<std::pair<uint256, bool>> result;
+        result.reserve(filters.size());
+        for (const BlockFilter& filter : filters) result.emplace_back(filter.GetBlockHash(), false);
+        for (const size_t i : MatchAnyBlockFilters(filters, filter_set, pool)) result[i].second = true;
+        return result;
+    }
     bool findBlock(const uint256& hash, const FoundBlock& block) override
     {
         WAIT_LOCK(cs_main, lock);
@@ -551,10 +551,9 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
 
 std::optional<BlockRef> GetTip(ChainstateManager& chainman)
 {
-    LOCK(::cs_main);
-    CBlockIndex* tip{chainman.ActiveChain().Tip()};
+    const auto tip{chainman.ActiveTipSnapshot()};
     if (!tip) return {};
-    return BlockRef{tip->GetBlockHash(), tip->nHeight};
+    return BlockRef{tip->tip->GetBlockHash(), tip->height};
 }
 
 std::optional<BlockRef> WaitTipChanged(ChainstateManager& chainman, KernelNotifications& kernel_notifications, const uint256& current_tip, MillisecondsDouble& timeout)
@@ -581,8 +580,6 @@ std::optional<BlockRef> WaitTipChanged(ChainstateManager& chainman, KernelNotifi
     }
     if (chainman.m_interrupt) return {};
 
-    // Must release m_tip_block_mutex before getTip() locks cs_main, to
-    // avoid deadlocks.
     return GetTip(chainman);
 }
 
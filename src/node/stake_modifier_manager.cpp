@@ -10,12 +10,11 @@ namespace node {
 
 std::optional<uint256> StakeModifierManager::GetStakeModifier(const uint256& block_hash)
 {
-    LOCK(cs_main);
     std::lock_guard<std::mutex> lock(m_mutex);
     auto it = m_cache.find(block_hash);
     if (it != m_cache.end()) return it->second;
 
-    const CBlockIndex* index = m_chainman.m_blockman.LookupBlockIndex(block_hash);
+    const CBlockIndex* index = m_chainman.m_blockman.LookupBlockIndexShared(block_hash);
     if (index == nullptr) return std::nullopt;
 
     // Walk back until a cached modifier is found.
@@ -41,9 +40,8 @@ std::optional<uint256> StakeModifierManager::GetStakeModifier(const uint256& blo
 
 bool StakeModifierManager::ProcessStakeModifier(const uint256& block_hash, const uint256& modifier)
 {
-    LOCK(cs_main);
     std::lock_guard<std::mutex> lock(m_mutex);
-    const CBlockIndex* index = m_chainman.m_blockman.LookupBlockIndex(block_hash);
+    const CBlockIndex* index = m_chainman.m_blockman.LookupBlockIndexShared(block_hash);
     if (index == nullptr) return false;
 
     // Determine expected modifier using cached data.
@@ -12,6 +12,9 @@ namespace node {
 
 /**
  * Simple manager for retrieving stake modifier data.
+ *
+ * Only reads fields of the block index that do not change once a block is
+ * linked into the tree, so it does not need cs_main.
  */
 class StakeModifierManager
 {
@@ -4,6 +4,9 @@
 
 #include <node/utxo_snapshot.h>
 
+#include <coins.h>
+#include <consensus/amount.h>
+#include <kernel/coinstats.h>
 #include <logging.h>
 #include <streams.h>
 #include <sync.h>
@@ -11,12 +14,21 @@
 #include <txdb.h>
 #include <uint256.h>
 #include <util/fs.h>
+#include <util/threadpool.h>
+#include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <deque>
+#include <future>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace node {
 
@@ -92,4 +104,89 @@ std::optional<fs::path> FindSnapshotChainstateDir(const fs::path& data_dir)
     return std::nullopt;
 }
 
+util::Result<MuHash3072> BulkLoadSnapshotCoins(
+    AutoFile& afile,
+    const SnapshotMetadata& metadata,
+    int base_height,
+    CCoinsViewDB& coins_db,
+    ThreadPool& pool,
+    const std::function<void()>& interruption_point)
+{
+    using Chunk = std::vector<std::pair<COutPoint, Coin>>;
+
+    const uint64_t coins_count{metadata.m_coins_count};
+    uint64_t coins_left{coins_count};
+    MuHash3072 muhash;
+    std::deque<std::future<MuHash3072>> partials;
+    // Bound the number of chunks kept alive by pending hashing tasks.
+    const size_t max_in_flight{pool.WorkersCount() + 1};
+    auto collect_partial{[&] {
+        muhash *= pool.Wait(partials.front());
+        partials.pop_front();
+    }};
+
+    Txid txid;
+    uint64_t group_left{0};
+    try {
+        while (coins_left > 0) {
+            if (interruption_point) interruption_point();
+
+            auto chunk{std::make_shared<Chunk>()};
+            chunk->reserve(std::min<uint64_t>(coins_left, SNAPSHOT_LOAD_CHUNK_COINS));
+            while (coins_left > 0 && chunk->size() < SNAPSHOT_LOAD_CHUNK_COINS) {
+                if (group_left == 0) {
+                    afile >> txid;
+                    group_left = ReadCompactSize(afile);
+                    if (group_left > coins_left) {
+                        return util::Error{Untranslated("Mismatch in coins count in snapshot metadata and actual snapshot data")};
+                    }
+                    continue;
+                }
+                const uint64_t n{ReadCompactSize(afile)};
+                Coin coin;
+                afile >> coin;
+                if (coin.nHeight > uint32_t(base_height) || n >= std::numeric_limits<uint32_t>::max()) {
+                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins", coins_count - coins_left))};
+                }
+                if (!MoneyRange(coin.out.nValue)) {
+                    return util::Error{Untranslated(strprintf("Bad snapshot data after deserializing %d coins - bad tx out value", coins_count - coins_left))};
+                }
+                chunk->emplace_back(COutPoint{txid, uint32_t(n)}, std::move(coin));
+                --group_left;
+                --coins_left;
+            }
+
+            std::sort(chunk->begin(), chunk->end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            partials.push_back(pool.Submit([chunk] {
+                MuHash3072 partial;
+                for (const auto& [outpoint, coin] : *chunk) {
+                    kernel::ApplyCoinHash(partial, outpoint, coin);
+                }
+                return partial;
+            }));
+            if (!coins_db.BulkWrite(*chunk)) {
+                return util::Error{Untranslated("Failed to write snapshot coins to the coins database")};
+            }
+            while (partials.size() > max_in_flight) collect_partial();
+        }
+    } catch (const std::ios_base::failure& e) {
+        return util::Error{Untranslated(strprintf("Bad snapshot format or truncated snapshot after deserializing %d coins: %s", coins_count - coins_left, e.what()))};
+    }
+
+    // Any remaining data means the metadata undercounted the coins.
+    bool out_of_coins{false};
+    try {
+        afile >> txid;
+    } catch (const std::ios_base::failure&) {
+        out_of_coins = true;
+    }
+    if (!out_of_coins) {
+        return util::Error{Untranslated(strprintf("Bad snapshot - coins left over after deserializing %d coins.", coins_count))};
+    }
+
+    while (!partials.empty()) collect_partial();
+    LogInfo("[snapshot] bulk-loaded %d coins\n", coins_count);
+    return muhash;
+}
+
 } // namespace node
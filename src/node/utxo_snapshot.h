@@ -7,6 +7,7 @@
 #define BITCOIN_NODE_UTXO_SNAPSHOT_H
 
 #include <chainparams.h>
+#include <crypto/muhash.h>
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
 #include <serialize.h>
@@ -15,15 +16,20 @@
 #include <util/chaintype.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/result.h>
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <string_view>
 
 // UTXO set snapshot magic bytes
 static constexpr std::array<uint8_t, 5> SNAPSHOT_MAGIC_BYTES = {'u', 't', 'x', 'o', 0xff};
 
+class AutoFile;
+class CCoinsViewDB;
 class Chainstate;
+class ThreadPool;
 
 namespace node {
 //! Metadata describing a serialized version of a UTXO set from which an
@@ -127,6 +133,33 @@ constexpr std::string_view SNAPSHOT_CHAINSTATE_SUFFIX = "_snapshot";
 //! Return a path to the snapshot-based chainstate dir, if one exists.
 std::optional<fs::path> FindSnapshotChainstateDir(const fs::path& data_dir);
 
+//! Number of coins decoded per chunk when bulk-loading a UTXO snapshot.
+static constexpr size_t SNAPSHOT_LOAD_CHUNK_COINS{1 << 16};
+
+/**
+ * Load the coins following @p metadata in a UTXO snapshot file directly into
+ * an empty coins database, bypassing the coins cache.
+ *
+ * Decoding the snapshot is inherently sequential, as coins are variable-length
+ * and grouped by txid, so it is done in chunks on the calling thread. Each
+ * chunk is sorted and bulk-written to @p coins_db, while the MuHash partial
+ * product of the chunk is computed on @p pool. The partial products are
+ * combined once all chunks have been processed.
+ *
+ * Coins at a height above @p base_height, with an out of range amount, or
+ * with an invalid output index cause the load to fail, as does a coin count
+ * not matching the metadata.
+ *
+ * @returns the MuHash of the loaded set, which must still be finalized.
+ */
+util::Result<MuHash3072> BulkLoadSnapshotCoins(
+    AutoFile& afile,
+    const SnapshotMetadata& metadata,
+    int base_height,
+    CCoinsViewDB& coins_db,
+    ThreadPool& pool,
+    const std::function<void()>& interruption_point = {});
+
 } // namespace node
 
 #endif // BITCOIN_NODE_UTXO_SNAPSHOT_H
@@ -13,8 +13,10 @@
 #include <core_io.h>
 #include <flatfile.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
+#include <key_io.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <primitives/block.h>
@@ -426,10 +428,11 @@ static bool rest_block(const std::any& context,
         pos = pblockindex->GetBlockPos();
     }
 
-    std::vector<std::byte> block_data{};
-    if (!chainman.m_blockman.ReadRawBlock(block_data, pos)) {
+    const auto block_view{chainman.m_blockman.ReadRawBlockView(pos)};
+    if (!block_view) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
+    const std::span<const std::byte> block_data{block_view->data()};
 
     switch (rf) {
     case RESTResponseFormat::BINARY: {
@@ -685,6 +688,83 @@ static bool rest_block_filter(const std::any& context, HTTPRequest* req, const s
     }
 }
 
+static bool rest_address_history(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+
+    // request is sent over URI scheme /rest/addresshistory/<address>[/<start_height>/<end_height>][?count=<count>&skip=<skip>]
+    std::vector<std::string> uri_parts = SplitString(param, '/');
+    if (uri_parts.size() != 1 && uri_parts.size() != 3) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/addresshistory/<address>[/<start_height>/<end_height>]");
+    }
+
+    std::string raw_count, raw_skip;
+    try {
+        raw_count = req->GetQueryParameter("count").value_or(util::ToString(DEFAULT_ADDRESS_HISTORY_COUNT));
+        raw_skip = req->GetQueryParameter("skip").value_or("0");
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+    const auto count{ToIntegral<size_t>(raw_count)};
+    if (!count || *count < 1 || *count > MAX_ADDRESS_HISTORY_COUNT) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Count is invalid or out of acceptable range (1-%u): %s", MAX_ADDRESS_HISTORY_COUNT, raw_count));
+    }
+    const auto skip{ToIntegral<size_t>(raw_skip)};
+    if (!skip) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid skip: " + raw_skip);
+    }
+
+    if (!g_address_index) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Address index is not enabled");
+    }
+
+    const CTxDestination dest{DecodeDestination(uri_parts[0])};
+    if (!IsValidDestination(dest)) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid address: " + SanitizeString(uri_parts[0], SAFE_CHARS_URI));
+    }
+
+    std::optional<int32_t> start_height{0};
+    std::optional<int32_t> end_height;
+    if (uri_parts.size() == 3) {
+        start_height = ToIntegral<int32_t>(uri_parts[1]);
+        end_height = ToIntegral<int32_t>(uri_parts[2]);
+        if (!start_height || !end_height || *start_height < 0 || *end_height < *start_height) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height range");
+        }
+    } else {
+        ChainstateManager* maybe_chainman = GetChainman(context, req);
+        if (!maybe_chainman) return false;
+        end_height = WITH_LOCK(cs_main, return maybe_chainman->ActiveHeight());
+    }
+
+    if (!g_address_index->BlockUntilSyncedToCurrentChain()) {
+        const IndexSummary summary{g_address_index->GetSummary()};
+        if (*end_height > summary.best_block_height) {
+            return RESTERR(req, HTTP_NOT_FOUND, strprintf("Address index is still syncing. Current height: %d", summary.best_block_height));
+        }
+    }
+
+    std::vector<AddressHistoryEntry> history;
+    if (!g_address_index->FindHistory(AddressIndex::HashScript(GetScriptForDestination(dest)), *start_height, *end_height, history, *skip, *count)) {
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Unable to read address history. This error is unexpected and indicates index corruption.");
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        std::string strJSON = AddressHistoryToJSON(history).write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
 // A bit of a hack - dependency on a function defined in rpc/blockchain.cpp
 RPCHelpMan getblockchaininfo();
 
@@ -1130,6 +1210,7 @@ static const struct {
       {"/rest/deploymentinfo", rest_deploymentinfo},
       {"/rest/blockhashbyheight/", rest_blockhash_by_height},
       {"/rest/spenttxouts/", rest_spent_txouts},
+      {"/rest/addresshistory/", rest_address_history},
 };
 
 void StartREST(const std::any& context)
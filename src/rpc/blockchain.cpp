@@ -20,9 +20,11 @@
 #include <deploymentstatus.h>
 #include <flatfile.h>
 #include <hash.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
 #include <interfaces/mining.h>
+#include <key_io.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
@@ -48,6 +50,7 @@
 #include <util/fs.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -56,6 +59,8 @@
 #include <cstdint>
 
 #include <condition_variable>
+#include <deque>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -88,6 +93,25 @@ UniValue WriteUTXOSnapshot(
     const fs::path& temppath,
     const std::function<void()>& interruption_point = {});
 
+//! Number of txid ranges the UTXO set is split into when dumping it with worker threads.
+static constexpr int DUMP_PARTITIONS{64};
+//! Maximum number of worker threads for dumptxoutset.
+static constexpr int MAX_DUMP_THREADS{16};
+
+std::pair<std::vector<std::unique_ptr<CCoinsViewCursor>>, const CBlockIndex*>
+PrepareUTXOSnapshotPartitions(Chainstate& chainstate)
+    EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
+UniValue WriteUTXOSnapshotParallel(
+    Chainstate& chainstate,
+    std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors,
+    const CBlockIndex* tip,
+    AutoFile&& afile,
+    const fs::path& path,
+    const fs::path& temppath,
+    int num_threads,
+    const std::function<void()>& interruption_point = {});
+
 /* Calculate the difficulty for a given block index.
  */
 double GetDifficulty(const CBlockIndex& blockindex)
@@ -234,8 +258,8 @@ static RPCHelpMan getblockcount()
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
-    LOCK(cs_main);
-    return chainman.ActiveChain().Height();
+    const auto tip{chainman.ActiveTipSnapshot()};
+    return tip ? tip->height : -1;
 },
     };
 }
@@ -681,9 +705,8 @@ static CBlock GetBlockChecked(BlockManager& blockman, const CBlockIndex& blockin
     return block;
 }
 
-static std::vector<std::byte> GetRawBlockChecked(BlockManager& blockman, const CBlockIndex& blockindex)
+static node::RawBlockView GetRawBlockChecked(BlockManager& blockman, const CBlockIndex& blockindex)
 {
-    std::vector<std::byte> data{};
     FlatFilePos pos{};
     {
         LOCK(cs_main);
@@ -691,13 +714,14 @@ static std::vector<std::byte> GetRawBlockChecked(BlockManager& blockman, const C
         pos = blockindex.GetBlockPos();
     }
 
-    if (!blockman.ReadRawBlock(data, pos)) {
+    auto data{blockman.ReadRawBlockView(pos)};
+    if (!data) {
         // Block not found on disk. This shouldn't normally happen unless the block was
         // pruned right after we released the lock above.
         throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
     }
 
-    return data;
+    return std::move(*data);
 }
 
 static CBlockUndo GetUndoChecked(BlockManager& blockman, const CBlockIndex& blockindex)
@@ -833,13 +857,13 @@ static RPCHelpMan getblock()
         }
     }
 
-    const std::vector<std::byte> block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
+    const node::RawBlockView block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
 
     if (verbosity <= 0) {
-        return HexStr(block_data);
+        return HexStr(block_data.data());
     }
 
-    DataStream block_stream{block_data};
+    DataStream block_stream{block_data.data()};
     CBlock block{};
     block_stream >> TX_WITH_WITNESS(block);
 
@@ -2954,6 +2978,112 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+UniValue AddressHistoryToJSON(const std::vector<AddressHistoryEntry>& history)
+{
+    UniValue result(UniValue::VARR);
+    for (const AddressHistoryEntry& entry : history) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.tx->GetHash().GetHex());
+        obj.pushKV("height", entry.height);
+        obj.pushKV("blockhash", entry.block_hash.GetHex());
+        if (entry.spending) {
+            const COutPoint& prevout{entry.tx->vin[entry.n].prevout};
+            obj.pushKV("type", "spend");
+            obj.pushKV("vin", entry.n);
+            obj.pushKV("prevout_txid", prevout.hash.GetHex());
+            obj.pushKV("prevout_vout", prevout.n);
+        } else {
+            obj.pushKV("type", "receive");
+            obj.pushKV("vout", entry.n);
+            obj.pushKV("value", ValueFromAmount(entry.tx->vout[entry.n].nValue));
+        }
+        result.push_back(std::move(obj));
+    }
+    return result;
+}
+
+static RPCHelpMan getaddresshistory()
+{
+    return RPCHelpMan{
+        "getaddresshistory",
+        "Return the transactions that pay to or spend from an address, in block order.\n"
+        "Requires -addressindex. Long histories are returned in pages of at most count entries;\n"
+        "pass the number of entries already received as skip to get the next page.\n",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::NO, "The address"},
+                    {"start_height", RPCArg::Type::NUM, RPCArg::Default{0}, "The first block height to include"},
+                    {"end_height", RPCArg::Type::NUM, RPCArg::DefaultHint{"the current tip height"}, "The last block height to include"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{int(DEFAULT_ADDRESS_HISTORY_COUNT)}, strprintf("The number of entries to return (1 to %d)", MAX_ADDRESS_HISTORY_COUNT)},
+                    {"skip", RPCArg::Type::NUM, RPCArg::Default{0}, "The number of entries to skip"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                            {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                            {RPCResult::Type::STR_HEX, "blockhash", "The hash of the block containing the transaction"},
+                            {RPCResult::Type::STR, "type", "\"receive\" for an output paying to the address, \"spend\" for an input spending from it"},
+                            {RPCResult::Type::NUM, "vout", /*optional=*/true, "The output index (receive only)"},
+                            {RPCResult::Type::STR_AMOUNT, "value", /*optional=*/true, "The output value in " + CURRENCY_UNIT + " (receive only)"},
+                            {RPCResult::Type::NUM, "vin", /*optional=*/true, "The input index (spend only)"},
+                            {RPCResult::Type::STR_HEX, "prevout_txid", /*optional=*/true, "The transaction id of the spent output (spend only)"},
+                            {RPCResult::Type::NUM, "prevout_vout", /*optional=*/true, "The output index of the spent output (spend only)"},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 1000 2000") +
+                    HelpExampleCli("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 0 2000 100 200") +
+                    HelpExampleRpc("getaddresshistory", "\"" + EXAMPLE_ADDRESS[0] + "\", 1000, 2000")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_address_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Address index is not enabled. Use -addressindex");
+    }
+
+    const CTxDestination dest{DecodeDestination(request.params[0].get_str())};
+    if (!IsValidDestination(dest)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    const int start_height{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    int end_height;
+    {
+        ChainstateManager& chainman = EnsureAnyChainman(request.context);
+        LOCK(cs_main);
+        end_height = request.params[2].isNull() ? chainman.ActiveHeight() : request.params[2].getInt<int>();
+    }
+    if (start_height < 0 || end_height < start_height) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid height range");
+    }
+    const int count{self.Arg<int>("count")};
+    if (count < 1 || size_t(count) > MAX_ADDRESS_HISTORY_COUNT) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Count must be between 1 and %d", MAX_ADDRESS_HISTORY_COUNT));
+    }
+    const int skip{self.Arg<int>("skip")};
+    if (skip < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative skip");
+    }
+
+    if (!g_address_index->BlockUntilSyncedToCurrentChain()) {
+        const IndexSummary summary{g_address_index->GetSummary()};
+        if (end_height > summary.best_block_height) {
+            throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because addressindex is still syncing. Current height: %d", summary.best_block_height));
+        }
+    }
+
+    std::vector<AddressHistoryEntry> history;
+    if (!g_address_index->FindHistory(AddressIndex::HashScript(GetScriptForDestination(dest)), start_height, end_height, history, skip, count)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Unable to read address history. This error is unexpected and indicates index corruption.");
+    }
+    return AddressHistoryToJSON(history);
+},
+    };
+}
+
 /**
  * RAII class that disables the network in its constructor and enables it in its
  * destructor.
@@ -3011,6 +3141,8 @@ static RPCHelpMan dumptxoutset()
                     {"rollback", RPCArg::Type::NUM, RPCArg::Optional::OMITTED,
                         "Height or hash of the block to roll back to before creating the snapshot. Note: The further this number is from the tip, the longer this process will take. Consider setting a higher -rpcclienttimeout value in this case.",
                     RPCArgOptions{.skip_type_check = true, .type_str = {"", "string or numeric"}}},
+                    {"threads", RPCArg::Type::NUM, RPCArg::Default{0},
+                        strprintf("Number of worker threads (up to %d) serializing ranges of the UTXO set in parallel. The output is identical to a serial dump. 0 writes the snapshot on the calling thread.", MAX_DUMP_THREADS)},
                 },
             },
         },
@@ -3022,13 +3154,15 @@ static RPCHelpMan dumptxoutset()
                     {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
                     {RPCResult::Type::STR, "path", "the absolute path that the snapshot was written to"},
                     {RPCResult::Type::STR_HEX, "txoutset_hash", "the hash of the UTXO set contents"},
+                    {RPCResult::Type::STR_HEX, "txoutset_muhash", /*optional=*/true, "the MuHash of the UTXO set contents, combined from the partitions (only with threads > 0)"},
                     {RPCResult::Type::NUM, "nchaintx", "the number of transactions in the chain up to and including the base block"},
                 }
         },
         RPCExamples{
             HelpExampleCli("-rpcclienttimeout=0 dumptxoutset", "utxo.dat latest") +
             HelpExampleCli("-rpcclienttimeout=0 dumptxoutset", "utxo.dat rollback") +
-            HelpExampleCli("-rpcclienttimeout=0 -named dumptxoutset", R"(utxo.dat rollback=853456)")
+            HelpExampleCli("-rpcclienttimeout=0 -named dumptxoutset", R"(utxo.dat rollback=853456)") +
+            HelpExampleCli("-rpcclienttimeout=0 -named dumptxoutset", R"(utxo.dat latest threads=4)")
         },
         [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
@@ -3052,6 +3186,10 @@ static RPCHelpMan dumptxoutset()
     } else {
         throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid snapshot type \"%s\" specified. Please specify \"rollback\" or \"latest\"", snapshot_type));
     }
+    const int num_threads{options.exists("threads") ? options["threads"].getInt<int>() : 0};
+    if (num_threads < 0 || num_threads > MAX_DUMP_THREADS) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("threads must be between 0 and %d", MAX_DUMP_THREADS));
+    }
 
     const ArgsManager& args{EnsureAnyArgsman(request.context)};
     const fs::path path = fsbridge::AbsPathJoin(args.GetDataDirNet(), fs::u8path(request.params[0].get_str()));
@@ -3111,6 +3249,7 @@ static RPCHelpMan dumptxoutset()
 
     Chainstate* chainstate;
     std::unique_ptr<CCoinsViewCursor> cursor;
+    std::vector<std::unique_ptr<CCoinsViewCursor>> partition_cursors;
     CCoinsStats stats;
     {
         // Lock the chainstate before calling PrepareUtxoSnapshot, to be able
@@ -3130,11 +3269,30 @@ static RPCHelpMan dumptxoutset()
         if (target_index != chainstate->m_chain.Tip()) {
             LogWarning("dumptxoutset failed to roll back to requested height, reverting to tip.\n");
             throw JSONRPCError(RPC_MISC_ERROR, "Could not roll back to requested height.");
+        } else if (num_threads > 0) {
+            // The partition passes count and hash the coins themselves, so
+            // there is no serial pass over the UTXO set under cs_main.
+            std::tie(partition_cursors, tip) = PrepareUTXOSnapshotPartitions(*chainstate);
         } else {
             std::tie(cursor, stats, tip) = PrepareUTXOSnapshot(*chainstate, node.rpc_interruption_point);
         }
     }
 
+    if (num_threads > 0) {
+        UniValue result = WriteUTXOSnapshotParallel(*chainstate,
+                                                    partition_cursors,
+                                                    tip,
+                                                    std::move(afile),
+                                                    path,
+                                                    temppath,
+                                                    num_threads,
+                                                    node.rpc_interruption_point);
+        fs::rename(temppath, path);
+
+        result.pushKV("path", path.utf8string());
+        return result;
+    }
+
     UniValue result = WriteUTXOSnapshot(*chainstate,
                                         cursor.get(),
                                         &stats,
@@ -3189,6 +3347,150 @@ PrepareUTXOSnapshot(
     return {std::move(pcursor), *CHECK_NONFATAL(maybe_stats), tip};
 }
 
+//! Serialize the unspent outputs of one transaction in the UTXO snapshot format.
+template <typename Stream>
+static void SerializeSnapshotCoins(Stream& s, const Txid& txid, const std::vector<std::pair<uint32_t, Coin>>& coins)
+{
+    s << txid;
+    WriteCompactSize(s, coins.size());
+    for (const auto& [n, coin] : coins) {
+        WriteCompactSize(s, n);
+        s << coin;
+    }
+}
+
+std::pair<std::vector<std::unique_ptr<CCoinsViewCursor>>, const CBlockIndex*>
+PrepareUTXOSnapshotPartitions(Chainstate& chainstate)
+{
+    // All cursors must be created while cs_main is held, right after the
+    // flush, so they iterate over the same state (see PrepareUTXOSnapshot).
+    AssertLockHeld(::cs_main);
+    chainstate.ForceFlushStateToDisk();
+    std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+    for (int i = 0; i < DUMP_PARTITIONS; ++i) {
+        uint256 start;
+        start.begin()[0] = i * 256 / DUMP_PARTITIONS;
+        cursors.push_back(chainstate.CoinsDB().Cursor(COutPoint{Txid::FromUint256(start), 0}));
+    }
+    const CBlockIndex* tip{CHECK_NONFATAL(chainstate.m_blockman.LookupBlockIndex(chainstate.CoinsDB().GetBestBlock()))};
+    return {std::move(cursors), tip};
+}
+
+namespace {
+//! A serialized range of the UTXO set, together with the data for its hashes.
+struct SnapshotPartition {
+    DataStream data;
+    //! The coins as serialized for HASH_SERIALIZED, in the order it hashes them.
+    DataStream hash_data;
+    MuHash3072 muhash;
+    size_t coins_count{0};
+};
+} // namespace
+
+//! Serialize all coins whose txid starts with a byte below @p end_byte, starting at the cursor's position.
+static SnapshotPartition SerializeSnapshotPartition(CCoinsViewCursor& cursor, int end_byte, const std::function<void()>& interruption_point)
+{
+    SnapshotPartition partition;
+    COutPoint key;
+    Coin coin;
+    Txid last_hash;
+    std::vector<std::pair<uint32_t, Coin>> coins;
+    const auto add_tx_coins{[&] {
+        SerializeSnapshotCoins(partition.data, last_hash, coins);
+        // Like GetUTXOStats(), hash the outputs of a transaction by index,
+        // which is not always the key order.
+        std::ranges::sort(coins, {}, [](const auto& output) { return output.first; });
+        for (const auto& [n, coin] : coins) {
+            const size_t begin{partition.hash_data.size()};
+            kernel::ApplyCoinHash(partition.hash_data, COutPoint{last_hash, n}, coin);
+            partition.muhash.Insert(MakeUCharSpan(partition.hash_data).subspan(begin));
+        }
+        coins.clear();
+    }};
+    unsigned int iter{0};
+    while (cursor.Valid() && cursor.GetKey(key) && std::to_integer<int>(key.hash.begin()[0]) < end_byte) {
+        if (iter++ % 5000 == 0 && interruption_point) interruption_point();
+        if (cursor.GetValue(coin)) {
+            if (key.hash != last_hash && !coins.empty()) add_tx_coins();
+            last_hash = key.hash;
+            coins.emplace_back(key.n, coin);
+            ++partition.coins_count;
+        }
+        cursor.Next();
+    }
+    if (!coins.empty()) add_tx_coins();
+    return partition;
+}
+
+UniValue WriteUTXOSnapshotParallel(
+    Chainstate& chainstate,
+    std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors,
+    CCoinsStats* maybe_stats,
+    const CBlockIndex* tip,
+    AutoFile&& afile,
+    const fs::path& path,
+    const fs::path& temppath,
+    int num_threads,
+    const std::function<void()>& interruption_point)
+{
+    LOG_TIME_SECONDS(strprintf("writing UTXO snapshot at height %s (%s) to file %s (via %s) using %d threads",
+        tip->nHeight, tip->GetBlockHash().ToString(),
+        fs::PathToString(path), fs::PathToString(temppath), num_threads));
+
+    // The coins count is only known once all partitions are written, so the
+    // metadata is written again at the end.
+    afile << SnapshotMetadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), /*coins_count=*/0};
+
+    // Partitions are serialized by the workers and appended to the file in
+    // key order, so the output is identical to the serial dump. Only a
+    // bounded number of serialized partitions is held in memory at a time.
+    ThreadPool pool{"dumptxout"};
+    pool.Start(num_threads);
+    std::deque<std::future<SnapshotPartition>> pending;
+    size_t next{0};
+    auto submit_next{[&] {
+        const int end_byte{int(next + 1) * 256 / int(cursors.size())};
+        pending.push_back(pool.Submit([&cursor = *cursors[next], end_byte, &interruption_point] {
+            return SerializeSnapshotPartition(cursor, end_byte, interruption_point);
+        }));
+        ++next;
+    }};
+
+    HashWriter hasher;
+    MuHash3072 muhash;
+    size_t written_coins_count{0};
+    while (next < cursors.size() || !pending.empty()) {
+        while (next < cursors.size() && pending.size() <= size_t(num_threads)) submit_next();
+        SnapshotPartition partition{pool.Wait(pending.front())};
+        pending.pop_front();
+        afile.write(std::span<const std::byte>{partition.data.data(), partition.data.size()});
+        hasher.write(std::span<const std::byte>{partition.hash_data.data(), partition.hash_data.size()});
+        muhash *= partition.muhash;
+        written_coins_count += partition.coins_count;
+    }
+
+    afile.seek(0, SEEK_SET);
+    afile << SnapshotMetadata{chainstate.m_chainman.GetParams().MessageStart(), tip->GetBlockHash(), written_coins_count};
+
+    if (afile.fclose() != 0) {
+        throw std::ios_base::failure(
+            strprintf("Error closing %s: %s", fs::PathToString(temppath), SysErrorString(errno)));
+    }
+
+    uint256 muhash_out;
+    muhash.Finalize(muhash_out);
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("coins_written", written_coins_count);
+    result.pushKV("base_hash", tip->GetBlockHash().ToString());
+    result.pushKV("base_height", tip->nHeight);
+    result.pushKV("path", path.utf8string());
+    result.pushKV("txoutset_hash", hasher.GetHash().ToString());
+    result.pushKV("txoutset_muhash", muhash_out.ToString());
+    result.pushKV("nchaintx", tip->m_chain_tx_count);
+    return result;
+}
+
 UniValue WriteUTXOSnapshot(
     Chainstate& chainstate,
     CCoinsViewCursor* pcursor,
@@ -3222,13 +3524,8 @@ UniValue WriteUTXOSnapshot(
     // them to file using the below lambda function.
     // See also https://github.com/bitcoin/bitcoin/issues/25675
     auto write_coins_to_file = [&](AutoFile& afile, const Txid& last_hash, const std::vector<std::pair<uint32_t, Coin>>& coins, size_t& written_coins_count) {
-        afile << last_hash;
-        WriteCompactSize(afile, coins.size());
-        for (const auto& [n, coin] : coins) {
-            WriteCompactSize(afile, n);
-            afile << coin;
-            ++written_coins_count;
-        }
+        SerializeSnapshotCoins(afile, last_hash, coins);
+        written_coins_count += coins.size();
     };
 
     pcursor->GetKey(key);
@@ -3466,6 +3763,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scanblocks},
         {"blockchain", &getdescriptoractivity},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getaddresshistory},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
@@ -20,6 +20,7 @@ class CBlock;
 class CBlockIndex;
 class Chainstate;
 class UniValue;
+struct AddressHistoryEntry;
 namespace node {
 class BlockManager;
 struct NodeContext;
@@ -41,6 +42,9 @@ UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CB
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Address index history to JSON, as returned by getaddresshistory */
+UniValue AddressHistoryToJSON(const std::vector<AddressHistoryEntry>& history);
+
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
 
@@ -110,6 +110,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "getblock", 1, "verbosity" },
     { "getblock", 1, "verbose" },
     { "getblockheader", 1, "verbose" },
+    { "getaddresshistory", 1, "start_height" },
+    { "getaddresshistory", 2, "end_height" },
+    { "getaddresshistory", 3, "count" },
+    { "getaddresshistory", 4, "skip" },
     { "getchaintxstats", 0, "nblocks" },
     { "gettransaction", 1, "include_watchonly" },
     { "gettransaction", 2, "verbose" },
@@ -189,6 +193,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "gettxoutsetinfo", 2, "use_index"},
     { "dumptxoutset", 2, "options" },
     { "dumptxoutset", 2, "rollback" },
+    { "dumptxoutset", 2, "threads" },
+    { "getindexinfo", 1, "verbose" },
     { "lockunspent", 0, "unlock" },
     { "lockunspent", 1, "transactions" },
     { "lockunspent", 2, "persistent" },
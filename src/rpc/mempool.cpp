@@ -10,6 +10,7 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/spentindex.h>
 #include <kernel/mempool_entry.h>
 #include <net_processing.h>
 #include <node/mempool_persist_args.h>
@@ -28,6 +29,7 @@
 #include <util/time.h>
 #include <util/vector.h>
 
+#include <optional>
 #include <utility>
 
 using node::DumpMempool;
@@ -596,7 +598,8 @@ static RPCHelpMan getmempoolentry()
 static RPCHelpMan gettxspendingprevout()
 {
     return RPCHelpMan{"gettxspendingprevout",
-        "Scans the mempool to find transactions spending any of the given outputs",
+        "Scans the mempool to find transactions spending any of the given outputs.\n"
+        "With -spentindex, outputs spent in the active chain are reported as well, up to the last block the index has synced.",
         {
             {"outputs", RPCArg::Type::ARR, RPCArg::Optional::NO, "The transaction outputs that we want to check, and within each, the txid (string) vout (numeric).",
                 {
@@ -617,6 +620,8 @@ static RPCHelpMan gettxspendingprevout()
                     {RPCResult::Type::STR_HEX, "txid", "the transaction id of the checked output"},
                     {RPCResult::Type::NUM, "vout", "the vout value of the checked output"},
                     {RPCResult::Type::STR_HEX, "spendingtxid", /*optional=*/true, "the transaction id of the mempool transaction spending this output (omitted if unspent)"},
+                    {RPCResult::Type::NUM, "vin", /*optional=*/true, "the input index in the spending transaction (only for outputs spent in the active chain)"},
+                    {RPCResult::Type::NUM, "blockheight", /*optional=*/true, "the height of the block containing the spending transaction (only for outputs spent in the active chain)"},
                 }},
             }
         },
@@ -652,19 +657,46 @@ static RPCHelpMan gettxspendingprevout()
                 prevouts.emplace_back(txid, nOutput);
             }
 
-            const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-            LOCK(mempool.cs);
+            std::vector<std::optional<Txid>> mempool_spenders;
+            mempool_spenders.reserve(prevouts.size());
+            {
+                const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+                LOCK(mempool.cs);
+                for (const COutPoint& prevout : prevouts) {
+                    const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
+                    mempool_spenders.push_back(spendingTx ? std::make_optional(spendingTx->GetHash()) : std::nullopt);
+                }
+            }
+
+            // Look up the outputs not spent in the mempool in the index,
+            // without holding the mempool lock.
+            std::vector<std::optional<SpentIndexValue>> index_spenders(prevouts.size());
+            if (g_spent_index) {
+                g_spent_index->BlockUntilSyncedToCurrentChain();
+                std::vector<COutPoint> lookups;
+                for (size_t i = 0; i < prevouts.size(); ++i) {
+                    if (!mempool_spenders[i]) lookups.push_back(prevouts[i]);
+                }
+                auto spenders{g_spent_index->FindSpenders(lookups)};
+                for (size_t i = 0, j = 0; i < prevouts.size(); ++i) {
+                    if (!mempool_spenders[i]) index_spenders[i] = std::move(spenders[j++]);
+                }
+            }
 
             UniValue result{UniValue::VARR};
 
-            for (const COutPoint& prevout : prevouts) {
+            for (size_t i = 0; i < prevouts.size(); ++i) {
+                const COutPoint& prevout{prevouts[i]};
                 UniValue o(UniValue::VOBJ);
                 o.pushKV("txid", prevout.hash.ToString());
                 o.pushKV("vout", (uint64_t)prevout.n);
 
-                const CTransaction* spendingTx = mempool.GetConflictTx(prevout);
-                if (spendingTx != nullptr) {
-                    o.pushKV("spendingtxid", spendingTx->GetHash().ToString());
+                if (mempool_spenders[i]) {
+                    o.pushKV("spendingtxid", mempool_spenders[i]->ToString());
+                } else if (const auto& spender{index_spenders[i]}) {
+                    o.pushKV("spendingtxid", spender->txid.ToString());
+                    o.pushKV("vin", spender->input_index);
+                    o.pushKV("blockheight", spender->height);
                 }
 
                 result.push_back(std::move(o));
@@ -7,8 +7,10 @@
 
 #include <chainparams.h>
 #include <httpserver.h>
+#include <index/addressindex.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/spentindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
@@ -345,7 +347,7 @@ static RPCHelpMan echoipc()
     };
 }
 
-static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_name)
+static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_name, bool verbose)
 {
     UniValue ret_summary(UniValue::VOBJ);
     if (!index_name.empty() && index_name != summary.name) return ret_summary;
@@ -353,6 +355,13 @@ static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_na
     UniValue entry(UniValue::VOBJ);
     entry.pushKV("synced", summary.synced);
     entry.pushKV("best_block_height", summary.best_block_height);
+    if (verbose) {
+        UniValue commits(UniValue::VOBJ);
+        commits.pushKV("count", summary.commits);
+        commits.pushKV("last_latency_us", count_microseconds(summary.last_commit_latency));
+        commits.pushKV("max_latency_us", count_microseconds(summary.max_commit_latency));
+        entry.pushKV("commits", std::move(commits));
+    }
     ret_summary.pushKV(summary.name, std::move(entry));
     return ret_summary;
 }
@@ -363,7 +372,8 @@ static RPCHelpMan getindexinfo()
         "getindexinfo",
         "Returns the status of one or all available indices currently running in the node.\n",
                 {
-                    {"index_name", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Filter results for an index with a specific name."},
+                    {"index_name", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Filter results for an index with a specific name. Pass an empty string for all indices."},
+                    {"verbose", RPCArg::Type::BOOL, RPCArg::Default{false}, "Include index database commit metrics"},
                 },
                 RPCResult{
                     RPCResult::Type::OBJ_DYN, "", "", {
@@ -372,6 +382,12 @@ static RPCHelpMan getindexinfo()
                             {
                                 {RPCResult::Type::BOOL, "synced", "Whether the index is synced or not"},
                                 {RPCResult::Type::NUM, "best_block_height", "The block height to which the index is synced"},
+                                {RPCResult::Type::OBJ, "commits", /*optional=*/true, "Only present if verbose is true",
+                                {
+                                    {RPCResult::Type::NUM, "count", "Number of commits of the index state to its database since startup"},
+                                    {RPCResult::Type::NUM, "last_latency_us", "Time the last commit took until it was written, in microseconds. Includes waiting for commits of other indices in the same group."},
+                                    {RPCResult::Type::NUM, "max_latency_us", "Maximum commit latency since startup, in microseconds"},
+                                }},
                             }
                         },
                     },
@@ -381,22 +397,32 @@ static RPCHelpMan getindexinfo()
                   + HelpExampleRpc("getindexinfo", "")
                   + HelpExampleCli("getindexinfo", "txindex")
                   + HelpExampleRpc("getindexinfo", "txindex")
+                  + HelpExampleCli("getindexinfo", "\"\" true")
                 },
                 [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
 {
     UniValue result(UniValue::VOBJ);
     const std::string index_name = request.params[0].isNull() ? "" : request.params[0].get_str();
+    const bool verbose{self.Arg<bool>("verbose")};
 
     if (g_txindex) {
-        result.pushKVs(SummaryToJSON(g_txindex->GetSummary(), index_name));
+        result.pushKVs(SummaryToJSON(g_txindex->GetSummary(), index_name, verbose));
     }
 
     if (g_coin_stats_index) {
-        result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
+        result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name, verbose));
+    }
+
+    if (g_address_index) {
+        result.pushKVs(SummaryToJSON(g_address_index->GetSummary(), index_name, verbose));
+    }
+
+    if (g_spent_index) {
+        result.pushKVs(SummaryToJSON(g_spent_index->GetSummary(), index_name, verbose));
     }
 
-    ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
-        result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
+    ForEachBlockFilterIndex([&result, &index_name, verbose](const BlockFilterIndex& index) {
+        result.pushKVs(SummaryToJSON(index.GetSummary(), index_name, verbose));
     });
 
     return result;
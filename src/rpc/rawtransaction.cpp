@@ -182,7 +182,15 @@ PartiallySignedTransaction ProcessPSBT(const std::string& psbt_string, const std
 
     // Fetch previous transactions:
     // First, look in the txindex and the mempool
-    for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
+    std::vector<std::optional<std::pair<uint256, CTransactionRef>>> index_txs;
+    if (g_txindex) {
+        std::vector<uint256> prev_hashes;
+        for (unsigned int i = 0; i < psbtx.tx->vin.size(); ++i) {
+            if (!psbtx.inputs.at(i).non_witness_utxo) prev_hashes.push_back(psbtx.tx->vin.at(i).prevout.hash);
+        }
+        index_txs = g_txindex->FindTxs(prev_hashes);
+    }
+    for (unsigned int i = 0, lookup = 0; i < psbtx.tx->vin.size(); ++i) {
         PSBTInput& psbt_input = psbtx.inputs.at(i);
         const CTxIn& tx_in = psbtx.tx->vin.at(i);
 
@@ -193,8 +201,7 @@ PartiallySignedTransaction ProcessPSBT(const std::string& psbt_string, const std
 
         // Look in the txindex
         if (g_txindex) {
-            uint256 block_hash;
-            g_txindex->FindTx(tx_in.prevout.hash, block_hash, tx);
+            if (auto& found{index_txs.at(lookup++)}) tx = std::move(found->second);
         }
         // If we still don't have it look in the mempool
         if (!tx) {
@@ -0,0 +1,125 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <index/addressindex.h>
+#include <interfaces/chain.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(addressindex_tests)
+
+BOOST_AUTO_TEST_CASE(addressindex_positions_encoding)
+{
+    AddressIndexBlockPositions block;
+    block.block_pos = FlatFilePos{3, 123456};
+    block.positions = {{.tx_offset = 1, .n = 0, .spending = false},
+                       {.tx_offset = 1, .n = 7, .spending = true},
+                       {.tx_offset = 90000, .n = 1, .spending = false}};
+
+    DataStream stream;
+    stream << block;
+    // Block position (4 bytes), count (1 byte), then a one to three byte
+    // offset delta and a one byte index per position.
+    BOOST_CHECK_EQUAL(stream.size(), 4U + 1U + 2U + 2U + 4U);
+
+    AddressIndexBlockPositions decoded;
+    stream >> decoded;
+    BOOST_CHECK(decoded.block_pos == block.block_pos);
+    BOOST_CHECK(decoded.positions == block.positions);
+}
+
+BOOST_FIXTURE_TEST_CASE(addressindex_initial_sync, TestChain100Setup)
+{
+    AddressIndex address_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(address_index.Init());
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const uint256 coinbase_hash{AddressIndex::HashScript(coinbase_script)};
+
+    std::vector<AddressHistoryEntry> history;
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, 0, 100, history));
+    BOOST_CHECK(history.empty());
+
+    address_index.Sync();
+
+    // Every block of the test chain pays its coinbase to coinbaseKey.
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, 0, 100, history));
+    BOOST_REQUIRE_EQUAL(history.size(), m_coinbase_txns.size());
+    for (size_t i = 0; i < history.size(); ++i) {
+        BOOST_CHECK_EQUAL(history[i].height, int(i + 1));
+        BOOST_CHECK_EQUAL(history[i].tx->GetHash(), m_coinbase_txns[i]->GetHash());
+        BOOST_CHECK(!history[i].spending);
+    }
+
+    // Range iteration
+    history.clear();
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, 10, 19, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 10U);
+    BOOST_CHECK_EQUAL(history.front().height, 10);
+    BOOST_CHECK_EQUAL(history.back().height, 19);
+
+    // Spend a coinbase output to a new script in a new block.
+    CKey key{GenerateRandomKey()};
+    const CScript dest_script{GetScriptForDestination(PKHash(key.GetPubKey()))};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, dest_script, CAmount(1 * COIN), /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({spend}, coinbase_script)};
+    const int height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight())};
+    BOOST_CHECK(address_index.BlockUntilSyncedToCurrentChain());
+
+    history.clear();
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, height, height, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 2U);
+    BOOST_CHECK_EQUAL(history[0].tx->GetHash(), block.vtx[0]->GetHash());
+    BOOST_CHECK(!history[0].spending);
+    BOOST_CHECK_EQUAL(history[1].tx->GetHash(), spend.GetHash());
+    BOOST_CHECK(history[1].spending);
+    BOOST_CHECK_EQUAL(history[1].n, 0U);
+
+    // Paging: pages may start and end within a block.
+    std::vector<AddressHistoryEntry> page;
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, 0, height, page, /*skip=*/99, /*count=*/2));
+    BOOST_REQUIRE_EQUAL(page.size(), 2U);
+    BOOST_CHECK_EQUAL(page[0].height, 100);
+    BOOST_CHECK_EQUAL(page[1].tx->GetHash(), block.vtx[0]->GetHash());
+    page.clear();
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, 0, height, page, /*skip=*/101, /*count=*/5));
+    BOOST_REQUIRE_EQUAL(page.size(), 1U);
+    BOOST_CHECK_EQUAL(page[0].tx->GetHash(), spend.GetHash());
+    page.clear();
+    BOOST_CHECK(address_index.FindHistory(coinbase_hash, 0, height, page, /*skip=*/102, /*count=*/5));
+    BOOST_CHECK(page.empty());
+
+    history.clear();
+    BOOST_CHECK(address_index.FindHistory(AddressIndex::HashScript(dest_script), 0, height, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].tx->GetHash(), spend.GetHash());
+    BOOST_CHECK_EQUAL(history[0].height, height);
+
+    // Reorg the spend out; its entries are removed when the index rewinds.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+        BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(address_index.BlockUntilSyncedToCurrentChain());
+
+    history.clear();
+    BOOST_CHECK(address_index.FindHistory(AddressIndex::HashScript(dest_script), 0, height, history));
+    BOOST_CHECK(history.empty());
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification (see txindex_tests).
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    address_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,7 @@
 #include <node/miner.h>
 #include <test/util/blockfilter.h>
 #include <test/util/setup_common.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -267,6 +268,76 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_sync, BuildChainTestingSetup)
+{
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.SetSyncWorkers(3);
+    filter_index.Sync();
+
+    // Filters are appended in chain order, so every header commits to the
+    // filters of all previous blocks.
+    LOCK(cs_main);
+    uint256 last_header;
+    for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+         block_index != nullptr;
+         block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+        CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+    }
+
+    filter_index.Interrupt();
+    filter_index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_chain_match_range, TestChain100Setup)
+{
+    BOOST_REQUIRE(InitBlockFilterIndex([&]{ return interfaces::MakeChain(m_node); }, BlockFilterType::BASIC, 1 << 20, true, false));
+    BlockFilterIndex& filter_index{*GetBlockFilterIndex(BlockFilterType::BASIC)};
+    BOOST_REQUIRE(filter_index.Init());
+    filter_index.Sync();
+
+    auto chain{interfaces::MakeChain(m_node)};
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    for (const CScript& script : {coinbase_script, CScript() << OP_TRUE}) {
+        const GCSFilter::ElementSet elements{{script.begin(), script.end()}};
+        const uint256 start_hash{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[0]->GetBlockHash())};
+        const auto matches{chain->blockFiltersMatchAny(BlockFilterType::BASIC, start_hash, 1000, elements)};
+        BOOST_REQUIRE(matches);
+        // The range stops at the tip.
+        BOOST_REQUIRE_EQUAL(matches->size(), 101U);
+        for (int height = 0; height <= 100; ++height) {
+            const uint256 block_hash{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[height]->GetBlockHash())};
+            BOOST_CHECK_EQUAL((*matches)[height].first, block_hash);
+            BOOST_CHECK_EQUAL((*matches)[height].second, *chain->blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, elements));
+            // Every coinbase after genesis pays to the coinbase script.
+            if (script == coinbase_script) BOOST_CHECK_EQUAL((*matches)[height].second, height > 0);
+        }
+    }
+
+    const GCSFilter::ElementSet elements{{coinbase_script.begin(), coinbase_script.end()}};
+    const uint256 hash_90{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain()[90]->GetBlockHash())};
+    BOOST_CHECK_EQUAL(chain->blockFiltersMatchAny(BlockFilterType::BASIC, hash_90, 5, elements)->size(), 5U);
+    BOOST_CHECK(!chain->blockFiltersMatchAny(BlockFilterType::BASIC, uint256::ONE, 5, elements));
+
+    // Matching on a pool gives the same results.
+    ThreadPool pool{"filtermatch"};
+    pool.Start(2);
+    const auto matches{chain->blockFiltersMatchAny(BlockFilterType::BASIC, hash_90, 20, elements, &pool)};
+    BOOST_REQUIRE(matches);
+    BOOST_CHECK(*matches == *chain->blockFiltersMatchAny(BlockFilterType::BASIC, hash_90, 20, elements));
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification (see txindex_tests).
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    filter_index.Stop();
+
+    // The range also stops at the last block the index has a filter for.
+    const CBlock block{CreateAndProcessBlock({}, coinbase_script)};
+    BOOST_CHECK_EQUAL(chain->blockFiltersMatchAny(BlockFilterType::BASIC, hash_90, 1000, elements)->size(), 11U);
+    BOOST_CHECK(!chain->blockFiltersMatchAny(BlockFilterType::BASIC, block.GetHash(), 5, elements));
+    DestroyAllBlockFilterIndexes();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
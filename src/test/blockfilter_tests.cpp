@@ -12,7 +12,9 @@
 #include <streams.h>
 #include <undo.h>
 #include <univalue.h>
+#include <util/golombrice.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -176,14 +178,148 @@ BOOST_AUTO_TEST_CASE(blockfilters_json_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(golombrice_reader)
+{
+    for (const uint8_t P : {0, 1, 7, 19, 32}) {
+        std::vector<uint64_t> values;
+        std::vector<unsigned char> encoded;
+        {
+            VectorWriter stream{encoded, 0};
+            BitStreamWriter bitwriter{stream};
+            for (uint64_t i = 0; i < 500; ++i) {
+                // Include quotients longer than the 64 bits buffered by the reader.
+                values.push_back(i % 50 == 0 ? (uint64_t{200} << P) + i : (i * 0x9e3779b97f4a7c15) >> (60 - std::min<int>(P, 30)));
+                GolombRiceEncode(bitwriter, P, values.back());
+            }
+            bitwriter.Flush();
+        }
+
+        GolombRiceReader reader{std::as_bytes(std::span{encoded}), P};
+        for (const uint64_t value : values) {
+            BOOST_CHECK_EQUAL(reader.Read(), value);
+        }
+        BOOST_CHECK_EQUAL(reader.BytesRead(), encoded.size());
+
+        // Truncated data is detected.
+        GolombRiceReader truncated{std::as_bytes(std::span{encoded}).first(encoded.size() / 2), P};
+        BOOST_CHECK_THROW(while (true) truncated.Read(), std::ios_base::failure);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockfilter_match_many)
+{
+    GCSFilter::ElementSet queries;
+    std::vector<BlockFilter> filters;
+    for (int i = 0; i < 200; ++i) {
+        GCSFilter::ElementSet elements;
+        for (int j = 0; j < 20; ++j) {
+            GCSFilter::Element element(32);
+            element[0] = i;
+            element[1] = j;
+            // Every seventh filter contains a queried element.
+            if (i % 7 == 0 && j == 0) queries.insert(element);
+            elements.insert(std::move(element));
+        }
+        const uint256 block_hash{uint8_t(i)};
+        GCSFilter::Params params{block_hash.GetUint64(0), block_hash.GetUint64(1), BASIC_FILTER_P, BASIC_FILTER_M};
+        filters.emplace_back(BlockFilterType::BASIC, block_hash, GCSFilter{params, elements}.GetEncoded(), /*skip_decode_check=*/false);
+    }
+
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < filters.size(); ++i) {
+        if (filters[i].GetFilter().MatchAny(queries)) expected.push_back(i);
+    }
+    BOOST_CHECK_GE(expected.size(), 200U / 7);
+
+    BOOST_CHECK(MatchAnyBlockFilters(filters, queries) == expected);
+    ThreadPool pool{"filtertest"};
+    pool.Start(3);
+    BOOST_CHECK(MatchAnyBlockFilters(filters, queries, &pool) == expected);
+    BOOST_CHECK(MatchAnyBlockFilters({}, queries, &pool).empty());
+}
+
+BOOST_AUTO_TEST_CASE(blockfilter_stake_test)
+{
+    const auto p2pkh{[](unsigned char key_id) {
+        return CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, key_id) << OP_EQUALVERIFY << OP_CHECKSIG;
+    }};
+    const CScript stake_script{p2pkh(1)}, reward_script{p2pkh(2)}, payment_script{p2pkh(3)}, change_script{p2pkh(4)};
+    // Delegated stake of owner 5 to staker 6, paid to P2SH (see delegatestakeaddress).
+    const CScript delegation_redeem{CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 5) << OP_EQUALVERIFY << OP_CHECKSIGVERIFY
+                                              << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 6) << OP_EQUALVERIFY << OP_CHECKSIG};
+    const CScript delegation_script{CScript() << OP_HASH160 << std::vector<unsigned char>(20, 7) << OP_EQUAL};
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vout.emplace_back(0, CScript() << OP_TRUE);
+
+    CMutableTransaction coinstake;
+    coinstake.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), 0});
+    coinstake.vout.resize(2);
+    coinstake.vout[0].SetNull();
+    coinstake.vout[1] = CTxOut{100, reward_script};
+
+    // An ordinary payment, spending delegated stake.
+    CMutableTransaction payment;
+    payment.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), 1});
+    payment.vin[0].scriptSig = CScript() << std::vector<unsigned char>(72, 8) << std::vector<unsigned char>(33, 9) << ToByteVector(delegation_redeem);
+    payment.vout.emplace_back(200, payment_script);
+
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    block.vtx.push_back(MakeTransactionRef(coinstake));
+    block.vtx.push_back(MakeTransactionRef(payment));
+
+    CBlockUndo block_undo;
+    block_undo.vtxundo.emplace_back();
+    block_undo.vtxundo.back().vprevout.emplace_back(CTxOut(50, stake_script), 10, false);
+    block_undo.vtxundo.emplace_back();
+    block_undo.vtxundo.back().vprevout.emplace_back(CTxOut(300, delegation_script), 10, false);
+
+    const BlockFilter stake_filter(BlockFilterType::STAKE, block, block_undo);
+    BOOST_CHECK_EQUAL(stake_filter.GetFilterType(), BlockFilterType::STAKE);
+    const auto stake_match{[&](const CScript& script) { return stake_filter.GetFilter().Match(GCSFilter::Element(script.begin(), script.end())); }};
+    BOOST_CHECK(stake_match(stake_script));
+    BOOST_CHECK(stake_match(reward_script));
+    BOOST_CHECK(stake_match(p2pkh(5)));
+    BOOST_CHECK(stake_match(p2pkh(6)));
+    BOOST_CHECK(!stake_match(payment_script));
+    BOOST_CHECK(!stake_match(change_script));
+    BOOST_CHECK(!stake_match(CScript() << OP_TRUE));
+
+    // The basic filter has all scripts, but not the delegated keys.
+    const BlockFilter basic_filter(BlockFilterType::BASIC, block, block_undo);
+    const auto basic_match{[&](const CScript& script) { return basic_filter.GetFilter().Match(GCSFilter::Element(script.begin(), script.end())); }};
+    BOOST_CHECK(basic_match(payment_script));
+    BOOST_CHECK(basic_match(delegation_script));
+    BOOST_CHECK(!basic_match(p2pkh(5)));
+
+    // Filters for proof-of-work blocks without delegated stake are empty.
+    block.vtx.resize(1);
+    block_undo.vtxundo.clear();
+    BOOST_CHECK_EQUAL(BlockFilter(BlockFilterType::STAKE, block, block_undo).GetFilter().GetN(), 0U);
+
+    // Round trip through serialization.
+    DataStream stream{};
+    stream << stake_filter;
+    BlockFilter stake_filter2;
+    stream >> stake_filter2;
+    BOOST_CHECK_EQUAL(stake_filter2.GetFilterType(), BlockFilterType::STAKE);
+    BOOST_CHECK_EQUAL(stake_filter2.GetHash(), stake_filter.GetHash());
+}
+
 BOOST_AUTO_TEST_CASE(blockfilter_type_names)
 {
     BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::BASIC), "basic");
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::STAKE), "stake");
     BOOST_CHECK_EQUAL(BlockFilterTypeName(static_cast<BlockFilterType>(255)), "");
 
     BlockFilterType filter_type;
     BOOST_CHECK(BlockFilterTypeByName("basic", filter_type));
     BOOST_CHECK_EQUAL(filter_type, BlockFilterType::BASIC);
+    BOOST_CHECK(BlockFilterTypeByName("stake", filter_type));
+    BOOST_CHECK_EQUAL(filter_type, BlockFilterType::STAKE);
 
     BOOST_CHECK(!BlockFilterTypeByName("unknown", filter_type));
 }
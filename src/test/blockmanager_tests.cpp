@@ -2,25 +2,38 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <addresstype.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <key.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
 #include <primitives/block.h>
+#include <undo.h>
 #include <util/chaintype.h>
+#include <util/signalinterrupt.h>
 #include <validation.h>
 
+#include <atomic>
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
 #include <test/util/logging.h>
 #include <test/util/setup_common.h>
 
 using node::STORAGE_HEADER_BYTES;
+using node::BlockFileRecord;
+using node::BlockIndexSnapshotTag;
+using node::BlockMap;
 using node::BlockManager;
 using node::KernelNotifications;
 using node::MAX_BLOCKFILE_SIZE;
+using node::ReadBlockIndexSnapshot;
+using node::ScanBlockFile;
+using node::WriteBlockIndexSnapshot;
 
 // use BasicTestingSetup here for the data directory configuration, setup, and cleanup
 BOOST_FIXTURE_TEST_SUITE(blockmanager_tests, BasicTestingSetup)
@@ -137,6 +150,361 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_block_data_availability, TestChain100Setup)
     BOOST_CHECK(!blockman.CheckBlockDataAvailability(tip, *last_pruned_block));
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_columnar_undo)
+{
+    // Coins spent by a block, mostly from a few recent heights.
+    CBlockUndo blockundo;
+    for (int i = 0; i < 50; ++i) {
+        CTxUndo& txundo{blockundo.vtxundo.emplace_back()};
+        for (int j = 0; j < 1 + i % 3; ++j) {
+            CKey key{GenerateRandomKey()};
+            const CScript script{GetScriptForDestination(PKHash(key.GetPubKey()))};
+            txundo.vprevout.emplace_back(CTxOut{CAmount(i * 1000 + j), script}, 200'000 - (i * j) % 7, /*fCoinBaseIn=*/j == 2);
+        }
+    }
+    blockundo.vtxundo[3].vprevout[0].nHeight = 0;
+    blockundo.vtxundo[4].vprevout[0].nHeight = 0x7fffffff;
+
+    DataStream legacy, columnar;
+    legacy << blockundo;
+    SerializeColumnarUndo(columnar, blockundo);
+    BOOST_CHECK_LT(columnar.size(), legacy.size());
+
+    const auto check_equal{[](const CBlockUndo& a, const CBlockUndo& b, uint8_t columns) {
+        BOOST_REQUIRE_EQUAL(a.vtxundo.size(), b.vtxundo.size());
+        for (size_t i = 0; i < a.vtxundo.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(a.vtxundo[i].vprevout.size(), b.vtxundo[i].vprevout.size());
+            for (size_t j = 0; j < a.vtxundo[i].vprevout.size(); ++j) {
+                const Coin& x{a.vtxundo[i].vprevout[j]};
+                const Coin& y{b.vtxundo[i].vprevout[j]};
+                if (columns & undo_column::HEIGHTS) {
+                    BOOST_CHECK_EQUAL(x.nHeight, y.nHeight);
+                    BOOST_CHECK_EQUAL(x.fCoinBase, y.fCoinBase);
+                }
+                if (columns & undo_column::AMOUNTS) BOOST_CHECK_EQUAL(x.out.nValue, y.out.nValue);
+                if (columns & undo_column::SCRIPTS) BOOST_CHECK(x.out.scriptPubKey == y.out.scriptPubKey);
+            }
+        }
+    }};
+
+    // Both formats are read back in full.
+    for (DataStream* stream : {&legacy, &columnar}) {
+        DataStream copy{*stream};
+        CBlockUndo read;
+        UnserializeBlockUndo(copy, read);
+        BOOST_CHECK(copy.empty());
+        check_equal(blockundo, read, undo_column::ALL);
+    }
+
+    // Columnar data can be read one column at a time; the others are skipped.
+    for (const uint8_t column : {undo_column::HEIGHTS, undo_column::AMOUNTS, undo_column::SCRIPTS}) {
+        DataStream copy{columnar};
+        CBlockUndo read;
+        UnserializeBlockUndo(copy, read, column);
+        BOOST_CHECK(copy.empty());
+        check_equal(blockundo, read, column);
+        if (column != undo_column::SCRIPTS) BOOST_CHECK(read.vtxundo[0].vprevout[0].out.scriptPubKey.empty());
+    }
+
+    // Unknown versions and trailing column data are rejected.
+    DataStream bad_version{columnar};
+    bad_version[1] = std::byte{UNDO_VERSION_COLUMNAR + 1};
+    CBlockUndo read;
+    BOOST_CHECK_THROW(UnserializeBlockUndo(bad_version, read), std::ios_base::failure);
+    DataStream bad_column;
+    bad_column << UNDO_VERSION_MARKER << UNDO_VERSION_COLUMNAR;
+    WriteCompactSize(bad_column, 0);
+    bad_column << std::vector<uint8_t>{0x00} << std::vector<uint8_t>{} << std::vector<uint8_t>{};
+    BOOST_CHECK_THROW(UnserializeBlockUndo(bad_column, read), std::ios_base::failure);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_read_columnar_undo, TestChain100Setup)
+{
+    const CScript coinbase_script{GetScriptForDestination(PKHash(coinbaseKey.GetPubKey()))};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, coinbase_script, CAmount(1 * COIN), /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+
+    auto& blockman{m_node.chainman->m_blockman};
+    const CBlockIndex& tip{*WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+    CBlockUndo full, amounts;
+    BOOST_REQUIRE(blockman.ReadBlockUndo(full, tip));
+    BOOST_REQUIRE(blockman.ReadBlockUndo(amounts, tip, undo_column::AMOUNTS));
+    BOOST_REQUIRE_EQUAL(full.vtxundo.size(), 1U);
+    BOOST_REQUIRE_EQUAL(amounts.vtxundo.size(), 1U);
+    const Coin& coin{full.vtxundo[0].vprevout.at(0)};
+    BOOST_CHECK_EQUAL(coin.out.nValue, m_coinbase_txns[0]->vout[0].nValue);
+    BOOST_CHECK(coin.out.scriptPubKey == m_coinbase_txns[0]->vout[0].scriptPubKey);
+    BOOST_CHECK_EQUAL(coin.nHeight, 1U);
+    BOOST_CHECK(coin.fCoinBase);
+    BOOST_CHECK_EQUAL(amounts.vtxundo[0].vprevout.at(0).out.nValue, coin.out.nValue);
+    BOOST_CHECK(amounts.vtxundo[0].vprevout.at(0).out.scriptPubKey.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_lookup_shared, TestChain100Setup)
+{
+    auto& blockman{m_node.chainman->m_blockman};
+    const CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+    BOOST_CHECK_EQUAL(blockman.LookupBlockIndexShared(tip->GetBlockHash()), tip);
+    BOOST_CHECK(blockman.LookupBlockIndexShared(uint256::ONE) == nullptr);
+
+    // Headers added under cs_main are visible to a concurrent reader, fully linked.
+    std::vector<CBlockHeader> headers;
+    uint256 prev_hash{tip->GetBlockHash()};
+    for (int i = 0; i < 200; ++i) {
+        CBlockHeader header;
+        header.hashPrevBlock = prev_hash;
+        header.nTime = tip->nTime + 1 + i;
+        header.nBits = tip->nBits;
+        header.nNonce = i;
+        prev_hash = header.GetHash();
+        headers.push_back(header);
+    }
+
+    std::atomic<bool> done{false};
+    int bad_entries{0};
+    std::thread reader{[&] {
+        while (!done) {
+            for (const CBlockHeader& header : headers) {
+                const CBlockIndex* index{blockman.LookupBlockIndexShared(header.GetHash())};
+                if (!index) continue;
+                if (!index->pprev || index->pprev->GetBlockHash() != header.hashPrevBlock ||
+                    index->nHeight != index->pprev->nHeight + 1) {
+                    ++bad_entries;
+                }
+            }
+        }
+    }};
+    {
+        LOCK(::cs_main);
+        CBlockIndex* best_header{m_node.chainman->m_best_header};
+        for (const CBlockHeader& header : headers) {
+            blockman.AddToBlockIndex(header, best_header);
+        }
+    }
+    done = true;
+    reader.join();
+    BOOST_CHECK_EQUAL(bad_entries, 0);
+    BOOST_CHECK_EQUAL(blockman.LookupBlockIndexShared(headers.back().GetHash())->nHeight, tip->nHeight + int(headers.size()));
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_read_raw_block_view, TestChain100Setup)
+{
+    auto& blockman{m_node.chainman->m_blockman};
+    const auto read_both{[&](const FlatFilePos& pos) {
+        std::vector<std::byte> raw;
+        BOOST_REQUIRE(blockman.ReadRawBlock(raw, pos));
+        const auto view{blockman.ReadRawBlockView(pos)};
+        BOOST_REQUIRE(view);
+        BOOST_CHECK(std::ranges::equal(view->data(), raw));
+        // Obfuscated block files are never mapped.
+        BOOST_CHECK(!view->IsMapped());
+        return raw;
+    }};
+
+    const auto positions{WITH_LOCK(::cs_main, {
+        std::vector<FlatFilePos> positions;
+        for (const CBlockIndex* index{m_node.chainman->ActiveTip()}; index; index = index->pprev) {
+            positions.push_back(index->GetBlockPos());
+        }
+        return positions;
+    })};
+    for (const FlatFilePos& pos : positions) read_both(pos);
+
+    // A block appended after the file was mapped is still found.
+    const CBlock block{CreateAndProcessBlock({}, CScript() << OP_TRUE)};
+    const FlatFilePos pos{blockman.WriteBlock(block, 101)};
+    DataStream expected;
+    expected << TX_WITH_WITNESS(block);
+    BOOST_CHECK(std::ranges::equal(read_both(pos), std::span<const std::byte>{expected}));
+
+    // Invalid positions fail on both paths.
+    std::vector<std::byte> raw;
+    BOOST_CHECK(!blockman.ReadRawBlockView(FlatFilePos{pos.nFile, 0}));
+    BOOST_CHECK(!blockman.ReadRawBlock(raw, FlatFilePos{pos.nFile + 1, STORAGE_HEADER_BYTES}));
+    BOOST_CHECK(!blockman.ReadRawBlockView(FlatFilePos{pos.nFile + 1, STORAGE_HEADER_BYTES}));
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_read_raw_block_view_mapped)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .use_xor = false,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+    const CBlock& genesis{Params().GenesisBlock()};
+    const FlatFilePos pos{blockman.WriteBlock(genesis, 0)};
+    DataStream expected;
+    expected << TX_WITH_WITNESS(genesis);
+
+    const auto view{blockman.ReadRawBlockView(pos)};
+    BOOST_REQUIRE(view);
+    BOOST_CHECK(std::ranges::equal(view->data(), std::span<const std::byte>{expected}));
+#ifndef WIN32
+    BOOST_CHECK_EQUAL(view->IsMapped(), sizeof(void*) >= 8);
+#endif
+    std::vector<std::byte> raw;
+    BOOST_REQUIRE(blockman.ReadRawBlock(raw, pos));
+    BOOST_CHECK(std::ranges::equal(raw, std::span<const std::byte>{expected}));
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_scan_block_file, TestChain100Setup)
+{
+    auto& blockman{m_node.chainman->m_blockman};
+    AutoFile file{blockman.OpenBlockFile(FlatFilePos{0, 0}, /*fReadOnly=*/true)};
+    BOOST_REQUIRE(!file.IsNull());
+    const auto records{ScanBlockFile(file, 0, Params().MessageStart(), m_node.chainman->m_interrupt)};
+
+    LOCK(::cs_main);
+    BOOST_CHECK_EQUAL(records.size(), size_t(m_node.chainman->ActiveHeight() + 1));
+    for (const BlockFileRecord& record : records) {
+        const CBlockIndex* index{blockman.LookupBlockIndex(record.hash)};
+        BOOST_REQUIRE(index);
+        BOOST_CHECK(record.pos == index->GetBlockPos());
+        BOOST_CHECK_EQUAL(record.prev_hash, index->pprev ? index->pprev->GetBlockHash() : uint256{});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_scan_block_file_garbage)
+{
+    const CBlock& genesis{Params().GenesisBlock()};
+    DataStream block_data;
+    block_data << TX_WITH_WITNESS(genesis);
+    AutoFile file{fsbridge::fopen(m_args.GetDataDirNet() / "garbage.dat", "w+b")};
+    BOOST_REQUIRE(!file.IsNull());
+    const auto write_garbage{[&](size_t len) { file.write(std::vector<std::byte>(len, std::byte{0})); }};
+    const auto write_block{[&] {
+        file << Params().MessageStart() << uint32_t(block_data.size()) << std::span<const std::byte>{block_data};
+        return uint32_t(file.tell()) - uint32_t(block_data.size());
+    }};
+    // Garbage before, between and after the blocks is skipped, including a
+    // run longer than one search chunk and a record cut off by the end.
+    write_garbage(100);
+    const uint32_t pos1{write_block()};
+    const uint32_t pos2{write_block()};
+    write_garbage(100'000);
+    const uint32_t pos3{write_block()};
+    file << Params().MessageStart() << uint32_t(block_data.size()) << std::span{block_data}.first(100);
+
+    const auto records{ScanBlockFile(file, 7, Params().MessageStart(), *Assert(m_node.shutdown_signal))};
+    BOOST_REQUIRE_EQUAL(records.size(), 3U);
+    const std::array positions{pos1, pos2, pos3};
+    for (size_t i{0}; i < records.size(); ++i) {
+        BOOST_CHECK_EQUAL(records[i].hash, genesis.GetHash());
+        BOOST_CHECK(records[i].pos == FlatFilePos(7, positions[i]));
+    }
+    BOOST_CHECK_EQUAL(file.fclose(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockmanager_block_index_snapshot, TestChain100Setup)
+{
+    auto& blockman{m_node.chainman->m_blockman};
+    const fs::path path{m_args.GetDataDirNet() / "blockindex_test.dat"};
+    const BlockIndexSnapshotTag tag{.id = m_rng.rand256(), .last_file = 0, .last_file_blocks = 101};
+
+    LOCK(::cs_main);
+    BOOST_REQUIRE(WriteBlockIndexSnapshot(path, blockman.m_block_index, tag));
+
+    node::BlockMapMemoryResource resource;
+    BlockMap loaded{0, BlockHasher{}, BlockMap::key_equal{}, &resource};
+    BOOST_REQUIRE(ReadBlockIndexSnapshot(path, tag, loaded, /*num_threads=*/4));
+    BOOST_CHECK_EQUAL(loaded.size(), blockman.m_block_index.size());
+    for (const auto& [hash, index] : blockman.m_block_index) {
+        const auto it{loaded.find(hash)};
+        BOOST_REQUIRE(it != loaded.end());
+        const CBlockIndex& copy{it->second};
+        BOOST_CHECK_EQUAL(copy.GetBlockHash(), hash);
+        BOOST_CHECK_EQUAL(copy.pprev ? copy.pprev->GetBlockHash() : uint256{}, index.pprev ? index.pprev->GetBlockHash() : uint256{});
+        if (copy.pprev) BOOST_CHECK_EQUAL(copy.pprev, &loaded.at(copy.pprev->GetBlockHash()));
+        BOOST_CHECK_EQUAL(copy.nHeight, index.nHeight);
+        BOOST_CHECK_EQUAL(copy.nStatus, index.nStatus);
+        BOOST_CHECK_EQUAL(copy.nTx, index.nTx);
+        BOOST_CHECK(copy.GetBlockPos() == index.GetBlockPos());
+        BOOST_CHECK(copy.GetUndoPos() == index.GetUndoPos());
+        BOOST_CHECK_EQUAL(copy.GetBlockHeader().GetHash(), hash);
+    }
+
+    // A snapshot for a different block tree database state is rejected.
+    BlockIndexSnapshotTag other_tag{tag};
+    ++other_tag.last_file_blocks;
+    BlockMap rejected{0, BlockHasher{}, BlockMap::key_equal{}, &resource};
+    BOOST_CHECK(!ReadBlockIndexSnapshot(path, other_tag, rejected, /*num_threads=*/1));
+    BOOST_CHECK(rejected.empty());
+
+    // So is a corrupted one.
+    {
+        std::vector<std::byte> data(fs::file_size(path));
+        AutoFile{fsbridge::fopen(path, "rb")}.read(data);
+        data.back() ^= std::byte{1};
+        AutoFile file{fsbridge::fopen(path, "wb")};
+        file.write(data);
+        BOOST_REQUIRE_EQUAL(file.fclose(), 0);
+    }
+    BOOST_CHECK(!ReadBlockIndexSnapshot(path, tag, rejected, /*num_threads=*/1));
+    BOOST_CHECK(rejected.empty());
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_block_index_snapshot_partial_load)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    util::SignalInterrupt interrupt;
+    const node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    const fs::path snapshot_path{m_args.GetBlocksDirPath() / "blockindex.dat"};
+
+    LOCK(::cs_main);
+    {
+        BlockManager blockman{interrupt, blockman_opts};
+        CBlockIndex* best_header{nullptr};
+        CBlockHeader header{Params().GenesisBlock().GetBlockHeader()};
+        blockman.AddToBlockIndex(header, best_header);
+        header.hashPrevBlock = header.GetHash();
+        blockman.AddToBlockIndex(header, best_header);
+        BOOST_REQUIRE(blockman.WriteBlockIndexDB());
+        // Nothing was loaded, so there is nothing to save either.
+        BOOST_CHECK(!blockman.WriteBlockIndexSnapshot());
+    }
+
+    // An interrupted load leaves a partial block index, which is not saved.
+    {
+        BlockManager blockman{interrupt, blockman_opts};
+        BOOST_REQUIRE(interrupt());
+        BOOST_CHECK(!blockman.LoadBlockIndexDB(std::nullopt));
+        BOOST_CHECK(!blockman.WriteBlockIndexSnapshot());
+        BOOST_CHECK(!fs::exists(snapshot_path));
+        BOOST_CHECK(!blockman.m_block_tree_db->ReadBlockIndexSnapshotId());
+        BOOST_REQUIRE(interrupt.reset());
+    }
+
+    // A complete load is saved, and any later block index flush drops the snapshot id.
+    {
+        BlockManager blockman{interrupt, blockman_opts};
+        BOOST_REQUIRE(blockman.LoadBlockIndexDB(std::nullopt));
+        BOOST_CHECK_EQUAL(blockman.m_block_index.size(), 2U);
+        BOOST_REQUIRE(blockman.WriteBlockIndexSnapshot());
+        BOOST_CHECK(fs::exists(snapshot_path));
+        BOOST_CHECK(blockman.m_block_tree_db->ReadBlockIndexSnapshotId());
+        int last_file{-1};
+        BOOST_CHECK(blockman.m_block_tree_db->ReadLastBlockFile(last_file));
+        BOOST_CHECK_EQUAL(last_file, 0);
+        BOOST_REQUIRE(blockman.WriteBlockIndexDB());
+        BOOST_CHECK(!blockman.m_block_tree_db->ReadBlockIndexSnapshotId());
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_readblock_hash_mismatch, TestingSetup)
 {
     CBlockIndex* fake_index{WITH_LOCK(m_node.chainman->GetMutex(), return m_node.chainman->ActiveChain().Tip())};
@@ -216,4 +584,38 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_finalize_block_file_in_background)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    const node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        .fast_prune = true,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    const fs::path first_file{m_args.GetBlocksDirPath() / "blk00000.dat"};
+    unsigned int first_file_size{0};
+    {
+        BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+        CBlock block;
+        // Fill up the first 64kiB block file, so that it is finalized when the
+        // second one is started.
+        FlatFilePos pos;
+        for (int height = 1; pos.nFile < 1; ++height) {
+            block.nNonce = height;
+            pos = blockman.WriteBlock(block, height);
+            BOOST_REQUIRE(!pos.IsNull());
+        }
+        first_file_size = blockman.GetBlockFileInfo(0)->nSize;
+        // The file is preallocated in 16kiB chunks, and truncated by the
+        // finalizing flush. Destroying the BlockManager waits for it.
+    }
+    BOOST_CHECK_EQUAL(fs::file_size(first_file), first_file_size);
+    BOOST_CHECK_EQUAL(m_node.exit_status.load(), EXIT_SUCCESS);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
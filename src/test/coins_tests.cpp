@@ -14,8 +14,10 @@
 #include <undo.h>
 #include <util/strencodings.h>
 
+#include <atomic>
 #include <map>
 #include <string>
+#include <thread>
 #include <variant>
 #include <vector>
 
@@ -1049,6 +1051,121 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_shared_tier)
+{
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    CCoinsViewShared shared{&base, /*max_bytes=*/1 << 20, /*deterministic=*/true};
+    CCoinsViewCacheTest cache{&shared};
+
+    const COutPoint kept{Txid::FromUint256(m_rng.rand256()), 0};
+    const COutPoint spent{Txid::FromUint256(m_rng.rand256()), 1};
+    const COutPoint fresh{Txid::FromUint256(m_rng.rand256()), 2};
+    CTxOut txout{int64_t(m_rng.randrange(MAX_MONEY)), CScript() << m_rng.randbytes(40)};
+
+    // Nothing is cached before the first flush, lookups fall through to the base.
+    cache.AddCoin(kept, Coin{txout, 1, false}, /*possible_overwrite=*/false);
+    cache.AddCoin(spent, Coin{txout, 1, false}, /*possible_overwrite=*/false);
+    BOOST_CHECK(!shared.GetCachedCoin(kept));
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(shared.GetCacheSize(), 2U);
+    BOOST_CHECK(shared.GetCachedCoin(kept)->out == txout);
+    BOOST_CHECK(shared.GetCoin(kept)->out == txout);
+
+    // Spends are recorded as tombstones, while spent FRESH coins are skipped.
+    BOOST_CHECK(cache.SpendCoin(spent));
+    cache.AddCoin(fresh, Coin{txout, 2, false}, /*possible_overwrite=*/false);
+    BOOST_CHECK(cache.SpendCoin(fresh));
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK_EQUAL(shared.GetCacheSize(), 2U);
+    BOOST_CHECK(shared.GetCachedCoin(spent)->IsSpent());
+    BOOST_CHECK(!shared.HaveCoin(spent));
+    BOOST_CHECK(!base.HaveCoin(spent));
+    BOOST_CHECK(!shared.GetCachedCoin(fresh));
+
+    // After clearing the tier, reads are served by the base view again.
+    shared.Clear();
+    BOOST_CHECK_EQUAL(shared.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK(!shared.GetCachedCoin(kept));
+    BOOST_CHECK(shared.GetCoin(kept)->out == txout);
+
+    // Writing more than the budget rotates generations and bounds memory usage.
+    for (uint32_t i{0}; i < 20'000; ++i) {
+        cache.AddCoin(COutPoint{Txid::FromUint256(m_rng.rand256()), i}, Coin{txout, 3, false}, /*possible_overwrite=*/false);
+    }
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(shared.DynamicMemoryUsage() <= 1 << 20);
+    BOOST_CHECK(shared.GetCacheSize() < 20'000);
+
+    // A disabled tier never caches anything.
+    CCoinsViewShared disabled{&base, /*max_bytes=*/0};
+    CCoinsViewCacheTest cache2{&disabled};
+    BOOST_CHECK(cache2.SpendCoin(kept));
+    BOOST_CHECK(cache2.Flush());
+    BOOST_CHECK_EQUAL(disabled.GetCacheSize(), 0U);
+    BOOST_CHECK(!disabled.HaveCoin(kept));
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_shared_tier_concurrent_readers)
+{
+    // The base is a LevelDB view, which is safe for concurrent reads, so the
+    // readers below may also fall through to it on tier misses.
+    CCoinsViewDB base{{.path = "test", .cache_bytes = 1 << 23, .memory_only = true}, {}};
+    // A small budget makes every flush rotate generations in most shards.
+    CCoinsViewShared shared{&base, /*max_bytes=*/64 << 10, /*deterministic=*/true};
+    CCoinsViewCacheTest cache{&shared};
+
+    const CTxOut txout{1000, CScript() << OP_TRUE};
+    std::vector<COutPoint> victims;
+    for (uint32_t i{0}; i < 1000; ++i) {
+        victims.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+        cache.AddCoin(victims.back(), Coin{txout, 1, false}, /*possible_overwrite=*/false);
+    }
+    BOOST_REQUIRE(cache.Flush());
+
+    std::atomic<bool> done{false};
+    std::atomic<int> resurrected{0};
+    std::atomic<int> observed_spent{0};
+    std::vector<std::thread> readers;
+    for (int t{0}; t < 3; ++t) {
+        readers.emplace_back([&] {
+            std::vector<bool> seen_spent(victims.size(), false);
+            // Always finish with a full pass after the last flush.
+            for (bool last{false}; !last;) {
+                last = done;
+                for (size_t i{0}; i < victims.size(); ++i) {
+                    // Alternate between both lookups, which share the same path.
+                    const bool unspent{i % 2 ? shared.HaveCoin(victims[i]) : shared.GetCoin(victims[i]).has_value()};
+                    if (unspent && seen_spent[i]) ++resurrected;
+                    if (!unspent && !seen_spent[i]) {
+                        seen_spent[i] = true;
+                        ++observed_spent;
+                    }
+                }
+            }
+        });
+    }
+
+    // Spend the victims over several flushes, each also writing enough new
+    // coins to push tombstones out of the tier.
+    for (size_t round{0}; round < 10; ++round) {
+        for (size_t i{round}; i < victims.size(); i += 10) {
+            BOOST_REQUIRE(cache.SpendCoin(victims[i]));
+        }
+        for (uint32_t i{0}; i < 2000; ++i) {
+            cache.AddCoin(COutPoint{Txid::FromUint256(m_rng.rand256()), i}, Coin{txout, 2, false}, /*possible_overwrite=*/false);
+        }
+        BOOST_REQUIRE(cache.Flush());
+    }
+    done = true;
+    for (std::thread& reader : readers) reader.join();
+
+    BOOST_CHECK_EQUAL(resurrected.load(), 0);
+    BOOST_CHECK_EQUAL(observed_spent.load(), int(readers.size() * victims.size()));
+    for (const COutPoint& victim : victims) {
+        BOOST_CHECK(!shared.HaveCoin(victim));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(coins_resource_is_used)
 {
     CCoinsMapMemoryResource resource;
@@ -73,6 +73,50 @@ BOOST_FIXTURE_TEST_CASE(coinstatsindex_initial_sync, TestChain100Setup)
     coin_stats_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(coinstatsindex_parallel_sync, TestChain100Setup)
+{
+    // Spend some coins so that blocks have both created and spent coins.
+    const CScript script_pub_key{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    for (int i = 0; i < 3; ++i) {
+        const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[i], 0, 1, coinbaseKey, script_pub_key, CAmount(1 * COIN), /*submit=*/false)};
+        CreateAndProcessBlock({spend}, script_pub_key);
+    }
+    const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+
+    // Sync without workers, where the block deltas are computed on the sync
+    // thread, and then with workers, where they are computed concurrently.
+    CoinStatsIndex serial_index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(serial_index.Init());
+    serial_index.Sync();
+    const auto serial_stats{serial_index.LookUpStats(*tip)};
+    BOOST_REQUIRE(serial_stats);
+
+    CoinStatsIndex parallel_index{interfaces::MakeChain(m_node), 1 << 20, true, /*f_wipe=*/true};
+    parallel_index.SetSyncWorkers(4);
+    BOOST_REQUIRE(parallel_index.Init());
+    parallel_index.Sync();
+    const auto parallel_stats{parallel_index.LookUpStats(*tip)};
+    BOOST_REQUIRE(parallel_stats);
+
+    BOOST_CHECK_EQUAL(parallel_stats->hashSerialized, serial_stats->hashSerialized);
+    BOOST_CHECK_EQUAL(parallel_stats->nTransactionOutputs, serial_stats->nTransactionOutputs);
+    BOOST_CHECK_EQUAL(parallel_stats->nBogoSize, serial_stats->nBogoSize);
+    BOOST_CHECK_EQUAL(*parallel_stats->total_amount, *serial_stats->total_amount);
+    BOOST_CHECK_EQUAL(parallel_stats->total_prevout_spent_amount, serial_stats->total_prevout_spent_amount);
+    BOOST_CHECK_EQUAL(parallel_stats->total_unspendable_amount, serial_stats->total_unspendable_amount);
+
+    // The index agrees with the UTXO set itself.
+    WITH_LOCK(cs_main, m_node.chainman->ActiveChainstate().ForceFlushStateToDisk());
+    const auto utxo_stats{WITH_LOCK(cs_main, return kernel::ComputeUTXOStats(kernel::CoinStatsHashType::MUHASH, &m_node.chainman->ActiveChainstate().CoinsDB(), m_node.chainman->m_blockman))};
+    BOOST_REQUIRE(utxo_stats);
+    BOOST_CHECK_EQUAL(parallel_stats->hashSerialized, utxo_stats->hashSerialized);
+    BOOST_CHECK_EQUAL(parallel_stats->nTransactionOutputs, utxo_stats->nTransactionOutputs);
+
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    serial_index.Stop();
+    parallel_index.Stop();
+}
+
 // Test shutdown between BlockConnected and ChainStateFlushed notifications,
 // make sure index is not corrupted and is able to reload.
 BOOST_FIXTURE_TEST_CASE(coinstatsindex_unclean_shutdown, TestChain100Setup)
@@ -22,6 +22,7 @@
 #include <util/strencodings.h>
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 #include <boost/test/unit_test.hpp>
@@ -1255,6 +1256,19 @@ BOOST_AUTO_TEST_CASE(muhash_tests)
     acc2.Finalize(out);
     BOOST_CHECK_EQUAL(out, uint256{"10d312b100cbd32ada024a6646e40d3482fcff103668d2625f10002a607d5863"});
 
+    // Normalized partial results combine to the same hash.
+    MuHash3072 part1 = FromInt(0);
+    part1 *= FromInt(1);
+    part1.Normalize();
+    MuHash3072 part2;
+    part2 /= FromInt(2);
+    part2.Normalize();
+    MuHash3072 acc3;
+    acc3 *= part1;
+    acc3 *= part2;
+    acc3.Finalize(out);
+    BOOST_CHECK_EQUAL(out, uint256{"10d312b100cbd32ada024a6646e40d3482fcff103668d2625f10002a607d5863"});
+
     // Test MuHash3072 serialization
     MuHash3072 serchk = FromInt(1); serchk *= FromInt(2);
     std::string ser_exp = "1fa093295ea30a6a3acdc7b3f770fa538eff537528e990e2910e40bbcfd7f6696b1256901929094694b56316de342f593303dd12ac43e06dce1be1ff8301c845beb15468fff0ef002dbf80c29f26e6452bccc91b5cb9437ad410d2a67ea847887fa3c6a6553309946880fe20db2c73fe0641adbd4e86edfee0d9f8cd0ee1230898873dc13ed8ddcaf045c80faa082774279007a2253f8922ee3ef361d378a6af3ddaf180b190ac97e556888c36b3d1fb1c85aab9ccd46e3deaeb7b7cf5db067a7e9ff86b658cf3acd6662bbcce37232daa753c48b794356c020090c831a8304416e2aa7ad633c0ddb2f11be1be316a81be7f7e472071c042cb68faef549c221ebff209273638b741aba5a81675c45a5fa92fea4ca821d7a324cb1e1a2ccd3b76c4228ec8066dad2a5df6e1bd0de45c7dd5de8070bdb46db6c554cf9aefc9b7b2bbf9f75b1864d9f95005314593905c0109b71f703d49944ae94477b51dac10a816bb6d1c700bafabc8bd86fac8df24be519a2f2836b16392e18036cb13e48c5c010000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000";
@@ -1280,4 +1294,28 @@ BOOST_AUTO_TEST_CASE(muhash_tests)
     BOOST_CHECK_EQUAL(HexStr(out4), "3a31e6903aff0de9f62f9a9f7f8b861de76ce2cda09822b90014319ae5dc2271");
 }
 
+BOOST_AUTO_TEST_CASE(num3072_multiply_implementations)
+{
+    BOOST_TEST_MESSAGE("Using Num3072 implementation " << MuHash3072AutoDetect());
+    const auto random_num{[&] {
+        Num3072 num;
+        for (auto& limb : num.limbs) limb = m_rng.rand64();
+        return num;
+    }};
+    // The largest value, which is above the modulus, and the modulus minus one.
+    Num3072 max_num, modulus_minus_one;
+    for (auto& limb : max_num.limbs) limb = std::numeric_limits<Num3072::limb_t>::max();
+    modulus_minus_one = max_num;
+    modulus_minus_one.limbs[0] -= 1103717;
+
+    for (int i = 0; i < 1000; ++i) {
+        Num3072 a{i % 4 == 1 ? max_num : random_num()};
+        const Num3072 b{i % 4 == 2 ? modulus_minus_one : i % 4 == 3 ? a : random_num()};
+        Num3072 expected{a};
+        expected.MultiplyGeneric(b);
+        a.Multiply(b);
+        BOOST_CHECK(std::ranges::equal(a.limbs, expected.limbs));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,11 +2,14 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <common/args.h>
 #include <dbwrapper.h>
+#include <node/database_args.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <uint256.h>
 #include <util/string.h>
+#include <util/translation.h>
 
 #include <memory>
 #include <ranges>
@@ -409,6 +412,122 @@ BOOST_AUTO_TEST_CASE(iterator_string_ordering)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_buffer_reuse)
+{
+    // Reads share per-thread buffers, so values of different sizes and
+    // failed reads must not leak into each other.
+    CDBWrapper dbw{{.path = m_args.GetDataDirBase() / "dbwrapper_buffer_reuse", .cache_bytes = 1 << 20, .memory_only = true, .obfuscate = true}};
+    const std::vector<uint8_t> large(DBWRAPPER_PREALLOC_VALUE_SIZE * 4, 0xab);
+    BOOST_CHECK(dbw.Write(uint8_t{'l'}, large));
+    BOOST_CHECK(dbw.Write(uint8_t{'s'}, uint256::ONE));
+
+    for (int i{0}; i < 2; ++i) {
+        std::vector<uint8_t> large_read;
+        BOOST_CHECK(dbw.Read(uint8_t{'l'}, large_read));
+        BOOST_CHECK(large_read == large);
+        uint256 small_read;
+        BOOST_CHECK(dbw.Read(uint8_t{'s'}, small_read));
+        BOOST_CHECK_EQUAL(small_read, uint256::ONE);
+        // A value that does not deserialize into the requested type.
+        std::pair<uint256, uint256> too_large;
+        BOOST_CHECK(!dbw.Read(uint8_t{'s'}, too_large));
+        BOOST_CHECK(dbw.Exists(uint8_t{'l'}));
+        BOOST_CHECK(!dbw.Exists(uint8_t{'m'}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_readmany)
+{
+    for (const bool obfuscate : {false, true}) {
+        CDBWrapper dbw{{.path = m_args.GetDataDirBase() / "dbwrapper_readmany", .cache_bytes = 1 << 20, .memory_only = true, .wipe_data = true, .obfuscate = obfuscate}};
+        for (uint32_t i{0}; i < 100; i += 2) {
+            BOOST_CHECK(dbw.Write(i, uint256{uint8_t(i)}));
+        }
+
+        // Unsorted keys, with duplicates and missing keys.
+        const std::vector<uint32_t> keys{98, 3, 0, 42, 42, 1000, 1};
+        std::vector<std::optional<uint256>> values(keys.size(), uint256::ONE);
+        BOOST_CHECK_EQUAL(dbw.ReadMany(std::span<const uint32_t>{keys}, std::span{values}), 4U);
+        for (size_t i{0}; i < keys.size(); ++i) {
+            uint256 value;
+            BOOST_CHECK_EQUAL(values[i].has_value(), dbw.Read(keys[i], value));
+            if (values[i]) BOOST_CHECK_EQUAL(*values[i], value);
+        }
+
+        BOOST_CHECK_EQUAL(dbw.ReadMany(std::span<const uint32_t>{}, std::span<std::optional<uint256>>{}), 0U);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dbwrapper_options)
+{
+    const fs::path path{m_args.GetDataDirBase() / "dbwrapper_options"};
+    const DBOptions options{.max_file_size = 2 << 20, .bloom_bits_per_key = 0, .block_size = 16 << 10, .block_cache_percent = 0, .background_compaction = true};
+    {
+        CDBWrapper dbw{{.path = path, .cache_bytes = 1 << 20, .wipe_data = true, .options = options}};
+        // All keys share their first byte, as in most databases, and there is
+        // enough data for the write buffer to be flushed to tables.
+        const std::vector<uint8_t> data(1000, 0x5a);
+        for (uint32_t i{0}; i < 4000; ++i) {
+            BOOST_CHECK(dbw.Write(std::make_pair(uint8_t{'C'}, i), std::make_pair(i, data)));
+        }
+
+        // Every call compacts the next key range of the registered database,
+        // and the ranges wrap around at the end.
+        for (int step{0}; step < 200; ++step) {
+            BOOST_CHECK_EQUAL(BackgroundCompactionStep(/*max_bytes=*/64 << 10), 1U);
+        }
+        for (uint32_t i{0}; i < 4000; ++i) {
+            std::pair<uint32_t, std::vector<uint8_t>> value;
+            BOOST_REQUIRE(dbw.Read(std::make_pair(uint8_t{'C'}, i), value));
+            BOOST_CHECK_EQUAL(value.first, i);
+            BOOST_CHECK(value.second == data);
+        }
+        BOOST_CHECK(!dbw.Exists(std::make_pair(uint8_t{'C'}, uint32_t{4000})));
+    }
+    // Closed databases are unregistered.
+    BOOST_CHECK_EQUAL(BackgroundCompactionStep(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(database_args)
+{
+    ArgsManager args;
+    for (const char* arg : {"-dbbloombits", "-dbblocksize", "-dbmaxfilesize"}) {
+        args.AddArg(arg, "", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    }
+    const char* argv[]{"ignored", "-dbbloombits=spentindex:20", "-dbbloombits=12", "-dbblocksize=8", "-dbmaxfilesize=txindex:2000"};
+    std::string error;
+    BOOST_REQUIRE(args.ParseParameters(std::size(argv), argv, error));
+
+    // Database-specific values take precedence over generic ones, whatever the order.
+    DBOptions options;
+    BOOST_REQUIRE(node::ReadDatabaseArgs(args, options, "chainstate"));
+    BOOST_CHECK_EQUAL(options.bloom_bits_per_key, 12);
+    BOOST_CHECK_EQUAL(options.block_size, 8U << 10);
+    BOOST_CHECK_EQUAL(options.max_file_size, DBWRAPPER_MAX_FILE_SIZE);
+
+    options = {};
+    BOOST_REQUIRE(node::ReadDatabaseArgs(args, options, "spentindex"));
+    BOOST_CHECK_EQUAL(options.bloom_bits_per_key, 20);
+
+    // Options override the built-in profiles.
+    options = {};
+    BOOST_REQUIRE(node::ReadDatabaseArgs(args, options, "addressindex"));
+    BOOST_CHECK_EQUAL(options.bloom_bits_per_key, 12);
+    BOOST_CHECK_EQUAL(options.block_size, 8U << 10);
+
+    // Out of range values are rejected.
+    options = {};
+    const auto result{node::ReadDatabaseArgs(args, options, "txindex")};
+    BOOST_REQUIRE(!result);
+    BOOST_CHECK_EQUAL(util::ErrorString(result).original, "-dbmaxfilesize must be between 2 and 1024.");
+
+    // Without options, the profiles apply.
+    options = {};
+    BOOST_REQUIRE(node::ReadDatabaseArgs(ArgsManager{}, options, "addressindex"));
+    BOOST_CHECK_EQUAL(options.bloom_bits_per_key, 0);
+    BOOST_CHECK_EQUAL(options.block_size, 16U << 10);
+}
+
 BOOST_AUTO_TEST_CASE(unicodepath)
 {
     // Attempt to create a database with a UTF8 character in the path.
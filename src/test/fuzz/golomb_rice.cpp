@@ -16,6 +16,8 @@
 #include <cassert>
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <span>
 #include <unordered_set>
 #include <vector>
 
@@ -80,6 +82,16 @@ FUZZ_TARGET(golomb_rice)
 
     assert(encoded_deltas == decoded_deltas);
 
+    {
+        SpanReader stream{golomb_rice_data};
+        const uint32_t n = static_cast<uint32_t>(ReadCompactSize(stream));
+        GolombRiceReader reader{std::as_bytes(std::span{golomb_rice_data}).last(stream.size()), BASIC_FILTER_P};
+        for (uint32_t i = 0; i < n; ++i) {
+            assert(reader.Read() == decoded_deltas[i]);
+        }
+        assert(reader.BytesRead() == stream.size());
+    }
+
     {
         const std::vector<uint8_t> random_bytes = ConsumeRandomLengthByteVector(fuzzed_data_provider, 1024);
         SpanReader stream{random_bytes};
@@ -89,12 +101,22 @@ FUZZ_TARGET(golomb_rice)
         } catch (const std::ios_base::failure&) {
             return;
         }
+        const uint8_t P{fuzzed_data_provider.ConsumeIntegralInRange<uint8_t>(0, 32)};
+        GolombRiceReader reader{std::as_bytes(std::span{random_bytes}).last(stream.size()), P};
         BitStreamReader bitreader{stream};
         for (uint32_t i = 0; i < std::min<uint32_t>(n, 1024); ++i) {
+            // Both decoders agree on the values, and on where the data ends.
+            std::optional<uint64_t> expected, decoded;
+            try {
+                expected = GolombRiceDecode(bitreader, P);
+            } catch (const std::ios_base::failure&) {
+            }
             try {
-                (void)GolombRiceDecode(bitreader, BASIC_FILTER_P);
+                decoded = reader.Read();
             } catch (const std::ios_base::failure&) {
             }
+            assert(expected == decoded);
+            if (!decoded) break;
         }
     }
 }
@@ -188,4 +188,36 @@ BOOST_AUTO_TEST_CASE(findearliestatleast_edge_test)
     BOOST_CHECK(ret2->nTimeMax >= 200 && ret2->nHeight == 4);
 }
 
+BOOST_AUTO_TEST_CASE(tip_snapshot_test)
+{
+    std::list<CBlockIndex> blocks;
+    for (int i = 0; i < 20; ++i) {
+        CBlockIndex* prev = blocks.empty() ? nullptr : &blocks.back();
+        blocks.emplace_back();
+        blocks.back().nHeight = prev ? prev->nHeight + 1 : 0;
+        blocks.back().pprev = prev;
+        blocks.back().BuildSkip();
+        blocks.back().nTime = 1000 + i;
+        blocks.back().nChainWork = i + 1;
+    }
+
+    CChain chain;
+    BOOST_CHECK(!chain.TipSnapshot());
+
+    chain.SetTip(blocks.back());
+    const auto tip{chain.TipSnapshot()};
+    BOOST_REQUIRE(tip);
+    BOOST_CHECK_EQUAL(tip->tip, chain.Tip());
+    BOOST_CHECK_EQUAL(tip->height, chain.Height());
+    BOOST_CHECK_EQUAL(tip->median_time_past, blocks.back().GetMedianTimePast());
+    BOOST_CHECK(tip->chain_work == arith_uint256{20});
+
+    // Moving the tip back publishes a new snapshot and leaves the old one intact.
+    CBlockIndex& fork_point{*std::next(blocks.begin(), 9)};
+    chain.SetTip(fork_point);
+    BOOST_CHECK_EQUAL(chain.TipSnapshot()->tip, &fork_point);
+    BOOST_CHECK_EQUAL(chain.TipSnapshot()->height, 9);
+    BOOST_CHECK_EQUAL(tip->height, 19);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <index/spentindex.h>
+#include <interfaces/chain.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(spentindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(spentindex_initial_sync, TestChain100Setup)
+{
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // Spend a coinbase output before the index is started.
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, coinbase_script, CAmount(1 * COIN), /*submit=*/false)};
+    CreateAndProcessBlock({spend}, coinbase_script);
+    const int spend_height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveHeight())};
+
+    SpentIndex spent_index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(spent_index.Init());
+
+    const COutPoint prevout{m_coinbase_txns[0]->GetHash(), 0};
+    BOOST_CHECK(!spent_index.FindSpender(prevout));
+
+    spent_index.Sync();
+
+    auto spender{spent_index.FindSpender(prevout)};
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->txid, spend.GetHash());
+    BOOST_CHECK_EQUAL(spender->input_index, 0U);
+    BOOST_CHECK_EQUAL(spender->height, spend_height);
+    BOOST_CHECK_EQUAL(spender->value, m_coinbase_txns[0]->vout[0].nValue);
+
+    // Unspent outputs are not found.
+    BOOST_CHECK(!spent_index.FindSpender(COutPoint{m_coinbase_txns[1]->GetHash(), 0}));
+    BOOST_CHECK(!spent_index.FindSpender(COutPoint{spend.GetHash(), 0}));
+
+    // Batched lookups match single ones.
+    const std::vector<COutPoint> outpoints{COutPoint{spend.GetHash(), 0}, prevout, COutPoint{m_coinbase_txns[1]->GetHash(), 0}};
+    const auto spenders{spent_index.FindSpenders(outpoints)};
+    BOOST_REQUIRE_EQUAL(spenders.size(), outpoints.size());
+    BOOST_CHECK(!spenders[0] && !spenders[2]);
+    BOOST_REQUIRE(spenders[1]);
+    BOOST_CHECK_EQUAL(spenders[1]->txid, spend.GetHash());
+    BOOST_CHECK_EQUAL(spenders[1]->height, spend_height);
+
+    // Spends in new blocks make it into the index.
+    const CMutableTransaction spend2{CreateValidMempoolTransaction(m_coinbase_txns[1], 0, 2, coinbaseKey, coinbase_script, CAmount(1 * COIN), /*submit=*/false)};
+    CreateAndProcessBlock({spend2}, coinbase_script);
+    BOOST_CHECK(spent_index.BlockUntilSyncedToCurrentChain());
+    spender = spent_index.FindSpender(COutPoint{m_coinbase_txns[1]->GetHash(), 0});
+    BOOST_REQUIRE(spender);
+    BOOST_CHECK_EQUAL(spender->txid, spend2.GetHash());
+    BOOST_CHECK_EQUAL(spender->height, spend_height + 1);
+
+    // Reorg the second spend out; its entry is removed when the index rewinds.
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+        BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(spent_index.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(!spent_index.FindSpender(COutPoint{m_coinbase_txns[1]->GetHash(), 0}));
+    BOOST_CHECK(spent_index.FindSpender(prevout));
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification (see txindex_tests).
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    spent_index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
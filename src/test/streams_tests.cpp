@@ -74,6 +74,29 @@ BOOST_AUTO_TEST_CASE(xor_bytes_reference)
     }
 }
 
+// Same as above, with sizes that span many cache lines, so the vectorized kernel is used.
+BOOST_AUTO_TEST_CASE(xor_bytes_reference_large)
+{
+    BOOST_TEST_MESSAGE("Using obfuscation implementation " << ObfuscationAutoDetect());
+    for (size_t test{0}; test < 100; ++test) {
+        const size_t write_size{m_rng.randrange(10'000U)};
+        const size_t key_offset{m_rng.randrange(3 * Obfuscation::KEY_SIZE)};
+        const size_t write_offset{std::min(write_size, m_rng.randrange(obfuscation_detail::CACHE_LINE_SIZE))};
+
+        const auto key_bytes{m_rng.randbytes<Obfuscation::KEY_SIZE>()};
+        const Obfuscation obfuscation{key_bytes};
+        std::vector expected{m_rng.randbytes<std::byte>(write_size)};
+        std::vector actual{expected};
+
+        for (size_t i{write_offset}; i < write_size; ++i) {
+            expected[i] ^= key_bytes[(key_offset + i - write_offset) % Obfuscation::KEY_SIZE];
+        }
+        obfuscation(std::span{actual}.subspan(write_offset), key_offset);
+
+        BOOST_CHECK(expected == actual);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(obfuscation_hexkey)
 {
     const auto key_bytes{m_rng.randbytes<Obfuscation::KEY_SIZE>()};
@@ -9,6 +9,10 @@
 #include <test/util/setup_common.h>
 #include <validation.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_AUTO_TEST_SUITE(txindex_tests)
@@ -73,4 +77,100 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_cache_and_batch, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true, false, /*max_cache_bytes=*/4 << 10);
+    BOOST_REQUIRE(txindex.Init());
+    txindex.Sync();
+
+    // Coinbase transactions, a duplicate and an unknown hash, in no particular order.
+    std::vector<uint256> tx_hashes;
+    for (auto it{m_coinbase_txns.rbegin()}; it != m_coinbase_txns.rend(); ++it) tx_hashes.push_back((*it)->GetHash());
+    tx_hashes.push_back(m_coinbase_txns[5]->GetHash());
+    tx_hashes.push_back(uint256::ONE);
+
+    // Lookups hit the cache from the second round on, and evict entries to
+    // stay within the memory limit.
+    for (int round = 0; round < 3; ++round) {
+        // The limit excludes the cache map's bucket array.
+        BOOST_CHECK_LE(txindex.DynamicMemoryUsage(), size_t{4 << 10} + 1024);
+        const auto found{txindex.FindTxs(tx_hashes)};
+        BOOST_REQUIRE_EQUAL(found.size(), tx_hashes.size());
+        BOOST_CHECK(!found.back());
+        for (size_t i = 0; i + 1 < tx_hashes.size(); ++i) {
+            BOOST_REQUIRE(found[i]);
+            BOOST_CHECK_EQUAL(found[i]->second->GetHash(), tx_hashes[i]);
+            uint256 block_hash;
+            CTransactionRef tx;
+            BOOST_REQUIRE(txindex.FindTx(tx_hashes[i], block_hash, tx));
+            BOOST_CHECK_EQUAL(found[i]->first, block_hash);
+            BOOST_CHECK_EQUAL(tx->GetHash(), tx_hashes[i]);
+        }
+    }
+
+    // A cached transaction that is mined again in another block after a
+    // reorg is found in its new block.
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, coinbase_script, CAmount(1 * COIN), /*submit=*/false)};
+    const CBlock first_block{CreateAndProcessBlock({spend}, coinbase_script)};
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    uint256 block_hash;
+    CTransactionRef tx;
+    BOOST_REQUIRE(txindex.FindTx(spend.GetHash(), block_hash, tx));
+    BOOST_CHECK_EQUAL(block_hash, first_block.GetHash());
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+        BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    const CBlock second_block{CreateAndProcessBlock({spend}, GetScriptForDestination(PKHash(coinbaseKey.GetPubKey())))};
+    BOOST_CHECK(txindex.BlockUntilSyncedToCurrentChain());
+    BOOST_REQUIRE(txindex.FindTx(spend.GetHash(), block_hash, tx));
+    BOOST_CHECK_EQUAL(block_hash, second_block.GetHash());
+    const auto found{txindex.FindTxs(std::vector<uint256>{spend.GetHash().ToUint256()})};
+    BOOST_REQUIRE(found[0]);
+    BOOST_CHECK_EQUAL(found[0]->first, second_block.GetHash());
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification (see above).
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    txindex.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(index_commit_group, BasicTestingSetup)
+{
+    constexpr int THREADS{8};
+    constexpr int COMMITS_PER_THREAD{50};
+    std::vector<std::unique_ptr<CDBWrapper>> dbs;
+    for (int i = 0; i < 2; ++i) {
+        dbs.push_back(std::make_unique<CDBWrapper>(DBParams{.path = m_args.GetDataDirNet() / fs::u8path(strprintf("commit_group_%d", i)), .cache_bytes = 1 << 10, .memory_only = true}));
+    }
+
+    IndexCommitGroup group;
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            CDBWrapper& db{*dbs[t % dbs.size()]};
+            for (int i = 0; i < COMMITS_PER_THREAD; ++i) {
+                CDBBatch batch{db};
+                batch.Write(std::make_pair(t, i), i);
+                if (!group.Commit(db, batch)) ++failures;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    BOOST_CHECK_EQUAL(failures, 0);
+    BOOST_CHECK_EQUAL(group.CommitCount(), uint64_t{THREADS * COMMITS_PER_THREAD});
+    BOOST_CHECK_LE(group.GroupCount(), group.CommitCount());
+    for (int t = 0; t < THREADS; ++t) {
+        for (int i = 0; i < COMMITS_PER_THREAD; ++i) {
+            int value{-1};
+            BOOST_CHECK(dbs[t % dbs.size()]->Read(std::make_pair(t, i), value));
+            BOOST_CHECK_EQUAL(value, i);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 //
 #include <chainparams.h>
 #include <consensus/validation.h>
+#include <kernel/coinstats.h>
 #include <kernel/disconnected_transactions.h>
 #include <node/chainstatemanager_args.h>
 #include <node/kernel_notifications.h>
@@ -18,6 +19,7 @@
 #include <test/util/validation.h>
 #include <uint256.h>
 #include <util/result.h>
+#include <util/threadpool.h>
 #include <util/vector.h>
 #include <validation.h>
 #include <validationinterface.h>
@@ -836,4 +838,62 @@ BOOST_FIXTURE_TEST_CASE(chainstatemanager_args, BasicTestingSetup)
     BOOST_CHECK(!get_opts({"-minimumchainwork=01234567890123456789012345678901234567890123456789012345678901234"})); // > 64 hex chars
 }
 
+BOOST_FIXTURE_TEST_CASE(snapshot_bulk_load, BasicTestingSetup)
+{
+    const int base_height{100};
+    SnapshotMetadata metadata{::Params().MessageStart(), m_rng.rand256(), 0};
+    std::map<COutPoint, Coin> coins;
+    MuHash3072 expected;
+
+    // Write a snapshot spanning several load chunks, with multiple coins per txid.
+    const fs::path path{m_path_root / "bulk_load.dat"};
+    {
+        AutoFile afile{fsbridge::fopen(path, "wb")};
+        const size_t num_txids{node::SNAPSHOT_LOAD_CHUNK_COINS / 2 + 7};
+        std::vector<std::pair<Txid, uint32_t>> groups;
+        for (size_t i{0}; i < num_txids; ++i) {
+            groups.emplace_back(Txid::FromUint256(m_rng.rand256()), 1 + m_rng.randrange(3));
+            metadata.m_coins_count += groups.back().second;
+        }
+        afile << metadata;
+        for (const auto& [txid, num_coins] : groups) {
+            afile << txid;
+            WriteCompactSize(afile, num_coins);
+            for (uint32_t n{0}; n < num_coins; ++n) {
+                Coin coin{CTxOut{int64_t(m_rng.randrange(MAX_MONEY)), CScript() << OP_TRUE}, int(m_rng.randrange(base_height)), false};
+                WriteCompactSize(afile, n);
+                afile << coin;
+                kernel::ApplyCoinHash(expected, COutPoint{txid, n}, coin);
+                coins.emplace(COutPoint{txid, n}, std::move(coin));
+            }
+        }
+        BOOST_REQUIRE_EQUAL(afile.fclose(), 0);
+    }
+
+    auto load{[&](int height, ThreadPool& pool, CCoinsViewDB& db) {
+        AutoFile afile{fsbridge::fopen(path, "rb")};
+        SnapshotMetadata read_metadata{::Params().MessageStart()};
+        afile >> read_metadata;
+        return node::BulkLoadSnapshotCoins(afile, read_metadata, height, db, pool);
+    }};
+
+    ThreadPool pool{"bulkload"};
+    pool.Start(2);
+    CCoinsViewDB db{{.path = "bulk_load", .cache_bytes = 1 << 20, .memory_only = true}, {}};
+    auto result{load(base_height, pool, db)};
+    BOOST_REQUIRE(result);
+    uint256 expected_hash, actual_hash;
+    expected.Finalize(expected_hash);
+    result->Finalize(actual_hash);
+    BOOST_CHECK_EQUAL(actual_hash, expected_hash);
+    for (const auto& [outpoint, coin] : coins) {
+        BOOST_CHECK(db.GetCoin(outpoint)->out == coin.out);
+    }
+
+    // Coins above the base height are rejected, also without worker threads.
+    ThreadPool serial_pool{"bulkload"};
+    CCoinsViewDB db2{{.path = "bulk_load2", .cache_bytes = 1 << 20, .memory_only = true}, {}};
+    BOOST_CHECK(!load(/*height=*/0, serial_pool, db2));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -168,6 +168,20 @@ bool CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashB
     return ret;
 }
 
+bool CCoinsViewDB::BulkWrite(std::span<const std::pair<COutPoint, Coin>> coins)
+{
+    CDBBatch batch(*m_db);
+    for (const auto& [outpoint, coin] : coins) {
+        batch.Write(CoinEntry(&outpoint), coin);
+        if (batch.ApproximateSize() > m_options.batch_write_bytes) {
+            if (!m_db->WriteBatch(batch)) return false;
+            batch.Clear();
+        }
+    }
+    LogDebug(BCLog::COINDB, "Bulk-loaded %u transaction outputs into coin database\n", coins.size());
+    return m_db->WriteBatch(batch);
+}
+
 size_t CCoinsViewDB::EstimateSize() const
 {
     return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
@@ -197,13 +211,18 @@ private:
 };
 
 std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
+{
+    return Cursor(COutPoint{Txid{}, 0});
+}
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor(const COutPoint& start) const
 {
     auto i = std::make_unique<CCoinsViewDBCursor>(
         const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
-    i->pcursor->Seek(DB_COIN);
+    i->pcursor->Seek(CoinEntry(&start));
     // Cache key of first record
     if (i->pcursor->Valid()) {
         CoinEntry entry(&i->keyTmp.second);
@@ -17,6 +17,8 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 class COutPoint;
@@ -24,6 +26,8 @@ class uint256;
 
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
+//! -sharedcoinscache default (MiB)
+static constexpr int64_t DEFAULT_SHARED_COINS_CACHE_MB{16};
 
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
@@ -32,6 +36,9 @@ struct CoinsViewOptions {
     //! If non-zero, randomly exit when the database is flushed with (1/ratio)
     //! probability.
     int simulate_crash_ratio = 0;
+    //! Memory budget in bytes of the concurrent tier of recently flushed
+    //! coins (see CCoinsViewShared). 0 disables it.
+    size_t shared_cache_bytes = DEFAULT_SHARED_COINS_CACHE_MB << 20;
 };
 
 /** CCoinsView backed by the coin database (chainstate/) */
@@ -50,6 +57,19 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    //! Get a cursor positioned at the first coin not ordered before @p start.
+    std::unique_ptr<CCoinsViewCursor> Cursor(const COutPoint& start) const;
+
+    /**
+     * Write coins straight to the database, bypassing any cache and its
+     * DIRTY/FRESH bookkeeping. Callers should pass coins sorted by outpoint.
+     * This keeps the coins of a txid together and mostly follows LevelDB's
+     * key order, though not exactly, as output indexes are VARINT-encoded.
+     *
+     * NOT FOR GENERAL USE. Used only when bulk-loading a UTXO snapshot into an
+     * empty database. The best block must be set afterwards by a regular flush.
+     */
+    bool BulkWrite(std::span<const std::pair<COutPoint, Coin>> coins);
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -11,6 +11,11 @@
 #include <consensus/consensus.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <streams.h>
+
+#include <cstdint>
+#include <ios>
+#include <span>
 
 /** Formatter for undo information for a CTxIn
  *
@@ -67,4 +72,147 @@ public:
     SERIALIZE_METHODS(CBlockUndo, obj) { READWRITE(obj.vtxundo); }
 };
 
+/** Columns of the columnar block undo format, as a mask of the ones to decode. */
+namespace undo_column {
+static constexpr uint8_t HEIGHTS{1 << 0}; //!< Coin::nHeight and Coin::fCoinBase
+static constexpr uint8_t AMOUNTS{1 << 1}; //!< CTxOut::nValue
+static constexpr uint8_t SCRIPTS{1 << 2}; //!< CTxOut::scriptPubKey
+static constexpr uint8_t ALL{0xff};
+} // namespace undo_column
+
+/**
+ * First byte of a columnar block undo record. The legacy format starts with
+ * the CompactSize transaction count, and a count starting with 0xff is either
+ * non-canonical or above MAX_SIZE, so older readers reject the record instead
+ * of misreading it.
+ */
+static constexpr uint8_t UNDO_VERSION_MARKER{0xff};
+static constexpr uint8_t UNDO_VERSION_COLUMNAR{1};
+
+namespace undo_detail {
+//! Undo data for a block cannot spend more coins than fit in it.
+static constexpr uint64_t MAX_BLOCK_UNDO_COINS{MAX_BLOCK_SERIALIZED_SIZE / 41};
+
+inline uint64_t ZigZagEncode(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+inline int64_t ZigZagDecode(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+template <typename Stream>
+void WriteColumn(Stream& s, const DataStream& column)
+{
+    WriteCompactSize(s, column.size());
+    s << std::span{column};
+}
+} // namespace undo_detail
+
+/**
+ * Serialize block undo data in the columnar format: the marker and version
+ * bytes, the transaction count, the number of spent coins of each
+ * transaction, and then three length-prefixed columns holding the heights,
+ * the amounts and the scripts of all spent coins in input order.
+ *
+ * Heights are delta coded against the previous coin, since the coins spent
+ * by a block mostly come from a few recent blocks, and the legacy dummy
+ * version byte is dropped. Keeping fields of one kind together lets readers
+ * that need a single column skip the others without decoding them.
+ */
+template <typename Stream>
+void SerializeColumnarUndo(Stream& s, const CBlockUndo& blockundo)
+{
+    DataStream heights, amounts, scripts;
+    int64_t prev_height{0};
+    s << UNDO_VERSION_MARKER << UNDO_VERSION_COLUMNAR;
+    WriteCompactSize(s, blockundo.vtxundo.size());
+    for (const CTxUndo& txundo : blockundo.vtxundo) {
+        WriteCompactSize(s, txundo.vprevout.size());
+        for (const Coin& coin : txundo.vprevout) {
+            const int64_t height{coin.nHeight};
+            heights << VARINT(undo_detail::ZigZagEncode(height - prev_height) * 2 + coin.fCoinBase);
+            prev_height = height;
+            amounts << Using<AmountCompression>(coin.out.nValue);
+            scripts << Using<ScriptCompression>(coin.out.scriptPubKey);
+        }
+    }
+    undo_detail::WriteColumn(s, heights);
+    undo_detail::WriteColumn(s, amounts);
+    undo_detail::WriteColumn(s, scripts);
+}
+
+/**
+ * Unserialize block undo data written in either the legacy or the columnar
+ * format. For columnar records, columns not selected by the mask are skipped
+ * and the corresponding fields keep their default values; legacy records are
+ * always decoded in full.
+ */
+template <typename Stream>
+void UnserializeBlockUndo(Stream& s, CBlockUndo& blockundo, uint8_t columns = undo_column::ALL)
+{
+    blockundo.vtxundo.clear();
+    const uint8_t first{ser_readdata8(s)};
+    if (first != UNDO_VERSION_MARKER) {
+        // Legacy record: finish reading the CompactSize transaction count
+        // whose first byte was consumed above.
+        uint64_t n_tx{first};
+        if (first == 253) {
+            n_tx = ser_readdata16(s);
+            if (n_tx < 253) throw std::ios_base::failure("non-canonical ReadCompactSize()");
+        } else if (first == 254) {
+            n_tx = ser_readdata32(s);
+            if (n_tx < 0x10000u) throw std::ios_base::failure("non-canonical ReadCompactSize()");
+        }
+        if (n_tx > undo_detail::MAX_BLOCK_UNDO_COINS) throw std::ios_base::failure("block undo: too many transactions");
+        blockundo.vtxundo.resize(n_tx);
+        for (CTxUndo& txundo : blockundo.vtxundo) s >> txundo;
+        return;
+    }
+
+    const uint8_t version{ser_readdata8(s)};
+    if (version != UNDO_VERSION_COLUMNAR) throw std::ios_base::failure("block undo: unknown version");
+
+    const uint64_t n_tx{ReadCompactSize(s)};
+    if (n_tx > undo_detail::MAX_BLOCK_UNDO_COINS) throw std::ios_base::failure("block undo: too many transactions");
+    blockundo.vtxundo.resize(n_tx);
+    uint64_t n_coins{0};
+    for (CTxUndo& txundo : blockundo.vtxundo) {
+        const uint64_t n{ReadCompactSize(s)};
+        n_coins += n;
+        if (n_coins > undo_detail::MAX_BLOCK_UNDO_COINS) throw std::ios_base::failure("block undo: too many coins");
+        txundo.vprevout.resize(n);
+    }
+
+    std::vector<std::byte> buf;
+    const auto read_column{[&](uint8_t column, auto&& decode) {
+        const uint64_t size{ReadCompactSize(s)};
+        if (!(columns & column)) {
+            s.ignore(size);
+            return;
+        }
+        buf.resize(size);
+        s >> std::span{buf};
+        SpanReader reader{buf};
+        for (CTxUndo& txundo : blockundo.vtxundo) {
+            for (Coin& coin : txundo.vprevout) decode(reader, coin);
+        }
+        if (!reader.empty()) throw std::ios_base::failure("block undo: trailing column data");
+    }};
+
+    int64_t prev_height{0};
+    read_column(undo_column::HEIGHTS, [&](SpanReader& reader, Coin& coin) {
+        uint64_t code{0};
+        reader >> VARINT(code);
+        // Deltas between 31-bit heights fit in 33 bits once coded.
+        if (code >> 33) throw std::ios_base::failure("block undo: height out of range");
+        const int64_t height{prev_height + undo_detail::ZigZagDecode(code >> 1)};
+        if (height < 0 || height > 0x7fffffff) throw std::ios_base::failure("block undo: height out of range");
+        coin.nHeight = uint32_t(height);
+        coin.fCoinBase = code & 1;
+        prev_height = height;
+    });
+    read_column(undo_column::AMOUNTS, [](SpanReader& reader, Coin& coin) {
+        reader >> Using<AmountCompression>(coin.out.nValue);
+    });
+    read_column(undo_column::SCRIPTS, [](SpanReader& reader, Coin& coin) {
+        reader >> Using<ScriptCompression>(coin.out.scriptPubKey);
+    });
+}
+
 #endif // BITCOIN_UNDO_H
@@ -9,7 +9,12 @@
 
 #include <streams.h>
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <ios>
+#include <span>
 
 template <typename OStream>
 void GolombRiceEncode(BitStreamWriter<OStream>& bitwriter, uint8_t P, uint64_t x)
@@ -42,4 +47,80 @@ uint64_t GolombRiceDecode(BitStreamReader<IStream>& bitreader, uint8_t P)
     return (q << P) + r;
 }
 
+/**
+ * Decoder for a sequence of Golomb-Rice coded values, producing the same
+ * values as repeated GolombRiceDecode() calls on a BitStreamReader. Instead of
+ * reading one bit at a time, it keeps up to 64 bits buffered and counts the
+ * unary-coded quotient with a single leading-ones count, which compiles to a
+ * bit scan instruction on most platforms.
+ */
+class GolombRiceReader
+{
+private:
+    std::span<const std::byte> m_data;
+    //! Index of the next byte of m_data to buffer.
+    size_t m_pos{0};
+    //! Buffered bits, most significant first. Bits past m_count are zero.
+    uint64_t m_bits{0};
+    //! Number of buffered bits.
+    int m_count{0};
+    const uint8_t m_P;
+
+    void Refill()
+    {
+        while (m_count <= 56 && m_pos < m_data.size()) {
+            m_bits |= uint64_t{std::to_integer<uint8_t>(m_data[m_pos++])} << (56 - m_count);
+            m_count += 8;
+        }
+    }
+
+    void Consume(int nbits)
+    {
+        m_bits = nbits == 64 ? 0 : m_bits << nbits;
+        m_count -= nbits;
+    }
+
+    //! Read up to 32 bits.
+    uint64_t ReadBits(int nbits)
+    {
+        if (nbits == 0) return 0;
+        Refill();
+        if (m_count < nbits) throw std::ios_base::failure("GolombRiceReader: end of data");
+        const uint64_t data{m_bits >> (64 - nbits)};
+        Consume(nbits);
+        return data;
+    }
+
+public:
+    GolombRiceReader(std::span<const std::byte> data, uint8_t P) : m_data{data}, m_P{P} {}
+
+    uint64_t Read()
+    {
+        // Read unary-encoded quotient: q 1's followed by one 0.
+        uint64_t q{0};
+        while (true) {
+            Refill();
+            const int ones{std::countl_one(m_bits)};
+            if (ones < m_count) {
+                q += ones;
+                Consume(ones + 1);
+                break;
+            }
+            if (m_count == 0) throw std::ios_base::failure("GolombRiceReader: end of data");
+            q += m_count;
+            Consume(m_count);
+        }
+
+        uint64_t r{0};
+        for (int nbits{m_P}; nbits > 0; nbits -= 32) {
+            const int chunk{std::min(nbits, 32)};
+            r = (r << chunk) | ReadBits(chunk);
+        }
+        return (q << m_P) + r;
+    }
+
+    //! Number of bytes of the input read so far, including a partially read last byte.
+    size_t BytesRead() const { return m_pos - m_count / 8; }
+};
+
 #endif // BITCOIN_UTIL_GOLOMBRICE_H
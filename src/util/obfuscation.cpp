@@ -0,0 +1,115 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/obfuscation.h>
+
+#include <compat/cpuid.h>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace obfuscation_avx2 {
+//! Defined in obfuscation_avx2.cpp, which uses the same line size.
+void XorCacheLines(std::byte* data, size_t count, uint64_t key);
+} // namespace obfuscation_avx2
+
+namespace {
+
+using obfuscation_detail::XorCacheLinesFn;
+
+[[maybe_unused]] void XorCacheLinesGeneric(std::byte* data, size_t count, uint64_t key)
+{
+    for (size_t i{0}; i < count * obfuscation_detail::CACHE_LINE_SIZE; i += sizeof(key)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        word ^= key;
+        std::memcpy(data + i, &word, sizeof(word));
+    }
+}
+
+#if defined(__SSE2__)
+/** SSE2 is part of the x86-64 baseline, so this needs no runtime detection there. */
+void XorCacheLinesSSE2(std::byte* data, size_t count, uint64_t key)
+{
+    const __m128i k{_mm_set1_epi64x(int64_t(key))};
+    for (size_t i{0}; i < count; ++i, data += obfuscation_detail::CACHE_LINE_SIZE) {
+        __m128i* p{reinterpret_cast<__m128i*>(data)};
+        _mm_storeu_si128(p + 0, _mm_xor_si128(_mm_loadu_si128(p + 0), k));
+        _mm_storeu_si128(p + 1, _mm_xor_si128(_mm_loadu_si128(p + 1), k));
+        _mm_storeu_si128(p + 2, _mm_xor_si128(_mm_loadu_si128(p + 2), k));
+        _mm_storeu_si128(p + 3, _mm_xor_si128(_mm_loadu_si128(p + 3), k));
+    }
+}
+#elif defined(__ARM_NEON)
+void XorCacheLinesNEON(std::byte* data, size_t count, uint64_t key)
+{
+    const uint64x2_t k{vdupq_n_u64(key)};
+    for (size_t i{0}; i < count; ++i, data += obfuscation_detail::CACHE_LINE_SIZE) {
+        uint64_t* p{reinterpret_cast<uint64_t*>(data)};
+        vst1q_u64(p + 0, veorq_u64(vld1q_u64(p + 0), k));
+        vst1q_u64(p + 2, veorq_u64(vld1q_u64(p + 2), k));
+        vst1q_u64(p + 4, veorq_u64(vld1q_u64(p + 4), k));
+        vst1q_u64(p + 6, veorq_u64(vld1q_u64(p + 6), k));
+    }
+}
+#endif
+
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+bool HaveAVX2()
+{
+    uint32_t eax, ebx, ecx, edx;
+    GetCPUID(1, 0, eax, ebx, ecx, edx);
+    const bool have_xsave{((ecx >> 27) & 1) != 0};
+    const bool have_avx{((ecx >> 28) & 1) != 0};
+    if (!have_xsave || !have_avx) return false;
+    // Check whether the OS has enabled AVX registers.
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    if ((a & 6) != 6) return false;
+    GetCPUID(7, 0, eax, ebx, ecx, edx);
+    return ((ebx >> 5) & 1) != 0;
+}
+#endif
+
+struct Implementation {
+    XorCacheLinesFn fn;
+    std::string name;
+};
+
+Implementation Detect()
+{
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    if (HaveAVX2()) return {obfuscation_avx2::XorCacheLines, "avx2"};
+#endif
+#if defined(__SSE2__)
+    return {XorCacheLinesSSE2, "sse2"};
+#elif defined(__ARM_NEON)
+    return {XorCacheLinesNEON, "neon"};
+#else
+    return {XorCacheLinesGeneric, "standard"};
+#endif
+}
+
+const Implementation& GetImplementation()
+{
+    static const Implementation implementation{Detect()};
+    return implementation;
+}
+
+} // namespace
+
+std::string ObfuscationAutoDetect()
+{
+    return GetImplementation().name;
+}
+
+obfuscation_detail::XorCacheLinesFn obfuscation_detail::GetXorCacheLines()
+{
+    return GetImplementation().fn;
+}
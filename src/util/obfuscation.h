@@ -15,6 +15,26 @@
 #include <climits>
 #include <ios>
 #include <memory>
+#include <string>
+
+namespace obfuscation_detail {
+//! Number of bytes processed at a time by an XorCacheLinesFn.
+static constexpr size_t CACHE_LINE_SIZE{64};
+//! Aligned buffers shorter than this are XORed inline, 64 bits at a time.
+//! With the kernel pointer cached in Obfuscation, ObfuscationBench shows the
+//! vectorized kernel ahead from a single cache line on (AVX2 and SSE2), so
+//! only the sub-line remainder stays inline.
+static constexpr size_t MIN_KERNEL_BYTES{CACHE_LINE_SIZE};
+
+/** XOR @p count consecutive 64-byte lines starting at @p data with the 8-byte key repeated. */
+using XorCacheLinesFn = void (*)(std::byte* data, size_t count, uint64_t key);
+
+/** Return the fastest XorCacheLinesFn, as selected by ObfuscationAutoDetect(). */
+XorCacheLinesFn GetXorCacheLines();
+} // namespace obfuscation_detail
+
+/** Return the name of the obfuscation kernel implementation, selecting the fastest available one on first use. */
+std::string ObfuscationAutoDetect();
 
 class Obfuscation
 {
@@ -44,11 +64,11 @@ public:
                 target = {std::assume_aligned<KEY_SIZE>(target.data() + alignment), target.size() - alignment};
                 rot_key = m_rotations[(key_offset + alignment) % KEY_SIZE];
             }
-            // Aligned obfuscation in 64-byte chunks
-            for (constexpr auto unroll{8}; target.size() >= KEY_SIZE * unroll; target = target.subspan(KEY_SIZE * unroll)) {
-                for (size_t i{0}; i < unroll; ++i) {
-                    XorWord(target.subspan(i * KEY_SIZE, KEY_SIZE), rot_key);
-                }
+            // Aligned obfuscation in whole cache lines, vectorized where supported
+            if (target.size() >= obfuscation_detail::MIN_KERNEL_BYTES) {
+                const size_t lines{target.size() / obfuscation_detail::CACHE_LINE_SIZE};
+                m_xor_cache_lines(target.data(), lines, rot_key);
+                target = target.subspan(lines * obfuscation_detail::CACHE_LINE_SIZE);
             }
             // Aligned obfuscation in 64-bit chunks
             for (; target.size() >= KEY_SIZE; target = target.subspan(KEY_SIZE)) {
@@ -84,6 +104,8 @@ public:
 private:
     // Cached key rotations for different offsets.
     std::array<KeyType, KEY_SIZE> m_rotations;
+    // Cached kernel, so that large buffers skip the implementation lookup.
+    obfuscation_detail::XorCacheLinesFn m_xor_cache_lines{obfuscation_detail::GetXorCacheLines()};
 
     void SetRotations(KeyType key)
     {
@@ -0,0 +1,29 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+
+namespace obfuscation_avx2 {
+
+// This file is compiled with AVX2 enabled, so it must not include headers
+// with inline functions that could also be used by code running without it.
+static constexpr size_t CACHE_LINE_SIZE{64};
+
+void XorCacheLines(std::byte* data, size_t count, uint64_t key)
+{
+    const __m256i k{_mm256_set1_epi64x(int64_t(key))};
+    for (size_t i{0}; i < count; ++i, data += CACHE_LINE_SIZE) {
+        __m256i* p{reinterpret_cast<__m256i*>(data)};
+        _mm256_storeu_si256(p + 0, _mm256_xor_si256(_mm256_loadu_si256(p + 0), k));
+        _mm256_storeu_si256(p + 1, _mm256_xor_si256(_mm256_loadu_si256(p + 1), k));
+    }
+}
+
+} // namespace obfuscation_avx2
+
+#endif // ENABLE_AVX2
@@ -0,0 +1,136 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_THREADPOOL_H
+#define BITCOIN_UTIL_THREADPOOL_H
+
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/check.h>
+#include <util/thread.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads processing a FIFO queue of tasks.
+ *
+ * Tasks are submitted with Submit(), which returns a std::future for the
+ * task's result. Exceptions thrown by a task are propagated through its
+ * future. The thread that owns the pool may help drain the queue by calling
+ * ProcessTask(), e.g. while waiting for results, which also makes a pool
+ * without any workers usable (all tasks then run on the calling thread).
+ *
+ * Stop() (also called on destruction) finishes all queued tasks before
+ * joining the workers.
+ */
+class ThreadPool
+{
+private:
+    const std::string m_name;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<std::packaged_task<void()>> m_work_queue GUARDED_BY(m_mutex);
+    bool m_interrupt GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (true) {
+            std::packaged_task<void()> task;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_interrupt || !m_work_queue.empty(); });
+                if (m_work_queue.empty()) return;
+                task = std::move(m_work_queue.front());
+                m_work_queue.pop();
+            }
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(std::string name) : m_name{std::move(name)} {}
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        Stop();
+    }
+
+    //! Start the given number of worker threads. Must not be called while workers are running.
+    void Start(int num_workers) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        Assume(m_workers.empty());
+        WITH_LOCK(m_mutex, m_interrupt = false);
+        for (int n = 0; n < num_workers; ++n) {
+            m_workers.emplace_back(&util::TraceThread, strprintf("%s.%i", m_name, n), [this] { WorkerThread(); });
+        }
+    }
+
+    //! Finish all queued tasks and join the worker threads.
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_interrupt = true);
+        m_cv.notify_all();
+        for (std::thread& worker : m_workers) worker.join();
+        m_workers.clear();
+        // Without workers, run anything that is left on this thread.
+        while (ProcessTask()) {}
+    }
+
+    //! Queue a task for execution and return a future for its result.
+    template <typename F>
+    [[nodiscard]] auto Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        using R = std::invoke_result_t<F>;
+        auto task{std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn))};
+        auto future{task->get_future()};
+        {
+            LOCK(m_mutex);
+            m_work_queue.emplace([task] { (*task)(); });
+        }
+        m_cv.notify_one();
+        return future;
+    }
+
+    //! Run one queued task on the calling thread. Returns false if the queue was empty.
+    bool ProcessTask() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::packaged_task<void()> task;
+        {
+            LOCK(m_mutex);
+            if (m_work_queue.empty()) return false;
+            task = std::move(m_work_queue.front());
+            m_work_queue.pop();
+        }
+        task();
+        return true;
+    }
+
+    //! Wait for a submitted task, helping to drain the queue in the meantime.
+    template <typename T>
+    T Wait(std::future<T>& future) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        while (future.wait_for(std::chrono::seconds::zero()) != std::future_status::ready) {
+            if (!ProcessTask()) future.wait();
+        }
+        return future.get();
+    }
+
+    size_t WorkersCount() const { return m_workers.size(); }
+};
+
+#endif // BITCOIN_UTIL_THREADPOOL_H
@@ -2218,19 +2218,19 @@ arith_uint256 CalculateClaimedHeadersWork(std::span<const CBlockHeader> headers)
 }
 
 CoinsViews::CoinsViews(DBParams db_params, CoinsViewOptions options)
-    : m_dbview{std::move(db_params), std::move(options)},
-      m_catcherview(&m_dbview) {}
+    : m_dbview{std::move(db_params), options},
+      m_catcherview(&m_dbview),
+      m_sharedview(&m_catcherview, options.shared_cache_bytes) {}
 
 void CoinsViews::InitCache()
 {
     AssertLockHeld(::cs_main);
-    m_cacheview = std::make_unique<CCoinsViewCache>(&m_catcherview);
+    m_cacheview = std::make_unique<CCoinsViewCache>(&m_sharedview);
 }
 
 Chainstate& ChainstateManager::ActiveChainstate() const
 {
-    Assert(m_active_chainstate);
-    return *m_active_chainstate;
+    return *Assert(m_active_chainstate.load(std::memory_order_acquire));
 }
 
 Chainstate::Chainstate(
@@ -2260,7 +2260,7 @@ void Chainstate::InitCoinsDB(
         leveldb_name += node::SNAPSHOT_CHAINSTATE_SUFFIX;
     }
 
-    m_coins_views = std::make_unique<CoinsViews>(
+    m_coins_views = std::make_shared<CoinsViews>(
         DBParams{
             .path = m_chainman.m_options.datadir / leveldb_name,
             .cache_bytes = cache_size_bytes,
@@ -2268,7 +2268,9 @@ void Chainstate::InitCoinsDB(
             .wipe_data = should_wipe,
             .obfuscate = true,
         },
-        CoinsViewOptions{});
+        m_chainman.m_options.coins_view);
+    LOCK(m_shared_coins_mutex);
+    m_shared_coins = std::shared_ptr<const CCoinsViewShared>{m_coins_views, &m_coins_views->m_sharedview};
 }
 
 void Chainstate::LoadDividendPool()
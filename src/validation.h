@@ -483,6 +483,12 @@ public:
     //! This view wraps access to the leveldb instance and handles read errors gracefully.
     CCoinsViewErrorCatcher m_catcherview GUARDED_BY(cs_main);
 
+    //! Concurrently readable tier of recently flushed coins. Only
+    //! CCoinsViewShared::GetCachedCoin() may be used without cs_main; misses
+    //! through GetCoin()/HaveCoin() fall through to m_catcherview, which is
+    //! only done by m_cacheview while cs_main is held.
+    CCoinsViewShared m_sharedview;
+
     //! This is the top layer of the cache hierarchy - it keeps as many coins in memory as
     //! can fit per the dbcache setting.
     std::unique_ptr<CCoinsViewCache> m_cacheview GUARDED_BY(cs_main);
@@ -537,7 +543,14 @@ protected:
     CTxMemPool* m_mempool;
 
     //! Manages the UTXO set, which is a reflection of the contents of `m_chain`.
-    std::unique_ptr<CoinsViews> m_coins_views;
+    std::shared_ptr<CoinsViews> m_coins_views;
+
+    //! Protects m_shared_coins, which readers copy without holding cs_main.
+    mutable Mutex m_shared_coins_mutex;
+
+    //! Handle on m_coins_views->m_sharedview that shares ownership of the
+    //! coins views, so that they outlive ResetCoinsViews() while in use.
+    std::shared_ptr<const CCoinsViewShared> m_shared_coins GUARDED_BY(m_shared_coins_mutex);
 
     //! This toggle exists for use when doing background validation for UTXO
     //! snapshots.
@@ -639,6 +652,16 @@ public:
         return *Assert(m_coins_views->m_cacheview);
     }
 
+    //! @returns A handle on the concurrently readable tier of recently flushed
+    //!     coins, or nullptr if no coins views are attached. The handle keeps
+    //!     the tier alive and may be used without cs_main, but only through
+    //!     CCoinsViewShared::GetCachedCoin(). Results reflect the UTXO set as of
+    //!     the last flush, not the current tip.
+    std::shared_ptr<const CCoinsViewShared> CoinsShared() const EXCLUSIVE_LOCKS_REQUIRED(!m_shared_coins_mutex)
+    {
+        return WITH_LOCK(m_shared_coins_mutex, return m_shared_coins);
+    }
+
     //! @returns A reference to the on-disk UTXO set database.
     CCoinsViewDB& CoinsDB() EXCLUSIVE_LOCKS_REQUIRED(::cs_main)
     {
@@ -665,7 +688,11 @@ public:
     }
 
     //! Destructs all objects related to accessing the UTXO set.
-    void ResetCoinsViews() { m_coins_views.reset(); }
+    void ResetCoinsViews() EXCLUSIVE_LOCKS_REQUIRED(!m_shared_coins_mutex)
+    {
+        WITH_LOCK(m_shared_coins_mutex, m_shared_coins.reset());
+        m_coins_views.reset();
+    }
 
     //! Does this chainstate have a UTXO set attached?
     bool HasCoinsViews() const { return (bool)m_coins_views; }
@@ -923,8 +950,10 @@ private:
     std::unique_ptr<Chainstate> m_snapshot_chainstate GUARDED_BY(::cs_main);
 
     //! Points to either the ibd or snapshot chainstate; indicates our
-    //! most-work chain.
-    Chainstate* m_active_chainstate GUARDED_BY(::cs_main) {nullptr};
+    //! most-work chain. Only changed with cs_main held, and atomic so that
+    //! ActiveTipSnapshot() can follow it without cs_main. The chainstates it
+    //! points to are not deleted until shutdown (see above).
+    std::atomic<Chainstate*> m_active_chainstate{nullptr};
 
     CBlockIndex* m_best_invalid GUARDED_BY(::cs_main){nullptr};
 
@@ -1118,6 +1147,12 @@ public:
     CChain& ActiveChain() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) { return ActiveChainstate().m_chain; }
     int ActiveHeight() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) { return ActiveChain().Height(); }
     CBlockIndex* ActiveTip() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) { return ActiveChain().Tip(); }
+    //! Tip of the active chain for callers that do not hold cs_main. See CChain::TipSnapshot().
+    std::shared_ptr<const ChainTipSnapshot> ActiveTipSnapshot() const
+    {
+        const Chainstate* chainstate{m_active_chainstate.load(std::memory_order_acquire)};
+        return chainstate ? chainstate->m_chain.TipSnapshot() : nullptr;
+    }
 
     //! The state of a background sync (for net processing)
     bool BackgroundSyncInProgress() const EXCLUSIVE_LOCKS_REQUIRED(GetMutex()) {
@@ -60,11 +60,8 @@ void BitGoldStaker::ThreadStakeMiner()
     while (!m_stop) {
         bool staked{false};
         try {
-            int chain_height;
-            {
-                LOCK(::cs_main);
-                chain_height = chainman.ActiveChain().Height();
-            }
+            const auto tip_snapshot{chainman.ActiveTipSnapshot()};
+            const int chain_height{tip_snapshot ? tip_snapshot->height : -1};
             const int min_depth = chain_height < MIN_STAKE_DEPTH ? 0 : MIN_STAKE_DEPTH;
             const std::chrono::seconds min_age =
                 chain_height < MIN_STAKE_DEPTH ? std::chrono::seconds{0} : MIN_COIN_AGE;
@@ -81,11 +78,7 @@ void BitGoldStaker::ThreadStakeMiner()
             if (candidates.empty()) {
                 LogDebug(BCLog::STAKING, "ThreadStakeMiner: no eligible UTXOs\n");
             } else {
-                CBlockIndex* pindexPrev;
-                {
-                    LOCK(::cs_main);
-                    pindexPrev = chainman.ActiveChain().Tip();
-                }
+                const CBlockIndex* pindexPrev{tip_snapshot ? tip_snapshot->tip : nullptr};
                 if (!pindexPrev) {
                     LogDebug(BCLog::STAKING, "ThreadStakeMiner: no tip block\n");
                 } else {
@@ -105,11 +98,9 @@ void BitGoldStaker::ThreadStakeMiner()
                             }
                             confirmed_block_hash = conf->confirmed_block_hash;
                         }
-                        const CBlockIndex* pindexFrom;
-                        {
-                            LOCK(::cs_main);
-                            pindexFrom = chainman.m_blockman.LookupBlockIndex(confirmed_block_hash);
-                        }
+                        // Only the hash and time of the block are used, which
+                        // can be read without cs_main.
+                        const CBlockIndex* pindexFrom{chainman.m_blockman.LookupBlockIndexShared(confirmed_block_hash)};
                         if (!pindexFrom) {
                             LogDebug(BCLog::STAKING, "ThreadStakeMiner: staking tx block not found\n");
                             continue;
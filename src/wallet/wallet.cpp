@@ -64,6 +64,7 @@
 #include <util/moneystr.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -82,6 +83,7 @@
 #include <cassert>
 #include <condition_variable>
 #include <exception>
+#include <future>
 #include <optional>
 #include <stdexcept>
 #include <thread>
@@ -311,10 +313,13 @@ std::shared_ptr<CWallet> LoadWalletInternal(WalletContext& context, const std::s
     }
 }
 
+//! Maximum number of threads used by a rescan with block filters.
+constexpr int MAX_RESCAN_THREADS{8};
+
 class FastWalletRescanFilter
 {
 public:
-    FastWalletRescanFilter(const CWallet& wallet) : m_wallet(wallet)
+    FastWalletRescanFilter(const CWallet& wallet, ThreadPool& pool) : m_wallet(wallet), m_pool(pool)
     {
         // create initial filter with scripts from all ScriptPubKeyMans
         for (auto spkm : m_wallet.GetAllScriptPubKeyMans()) {
@@ -338,17 +343,40 @@ public:
             if (current_range_end > last_range_end) {
                 AddScriptPubKeys(desc_spkm, last_range_end);
                 m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
+                // Results for upcoming blocks were computed without the new scripts.
+                m_batch.clear();
             }
         }
     }
 
-    std::optional<bool> MatchesBlock(const uint256& block_hash) const
+    std::optional<bool> MatchesBlock(const uint256& block_hash)
     {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+        // Blocks are scanned in order, so results are computed in batches of
+        // consecutive blocks, with the filters of a batch matched in parallel.
+        if (m_batch_pos >= m_batch.size() || m_batch[m_batch_pos].first != block_hash) {
+            m_batch = m_wallet.chain().blockFiltersMatchAny(BlockFilterType::BASIC, block_hash, FILTER_BATCH_SIZE, m_filter_set, &m_pool).value_or(std::vector<std::pair<uint256, bool>>{});
+            m_batch_pos = 0;
+            if (m_batch.empty() || m_batch.front().first != block_hash) {
+                m_batch.clear();
+                return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+            }
+        }
+        return m_batch[m_batch_pos++].second;
+    }
+
+    //! The next block after the last one passed to MatchesBlock() known to match, if any.
+    std::optional<uint256> NextMatchingBlock() const
+    {
+        for (size_t i = m_batch_pos; i < m_batch.size(); ++i) {
+            if (m_batch[i].second) return m_batch[i].first;
+        }
+        return std::nullopt;
     }
 
 private:
     const CWallet& m_wallet;
+    //! Pool of the rescan, on which filters are matched.
+    ThreadPool& m_pool;
     /** Map for keeping track of each range descriptor's last seen end range.
      * This information is used to detect whether new addresses were derived
      * (that is, if the current end range is larger than the saved end range)
@@ -358,6 +386,11 @@ private:
     std::map<uint256, int32_t> m_last_range_ends;
     GCSFilter::ElementSet m_filter_set;
 
+    static constexpr int FILTER_BATCH_SIZE{1000};
+    //! Filter match results for a range of consecutive blocks, and the position of the next block in it.
+    std::vector<std::pair<uint256, bool>> m_batch;
+    size_t m_batch_pos{0};
+
     void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
     {
         for (const auto& script_pub_key : desc_spkm->GetScriptPubKeys(last_range_end)) {
@@ -1782,8 +1815,16 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     uint256 block_hash = start_block;
     ScanResult result;
 
+    // Workers of the fast rescan, which match block filters and read the next
+    // matching block ahead. Stopped on return, after finishing queued reads.
+    ThreadPool pool{"rescan"};
     std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
-    if (chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
+    if (chain().hasBlockFilterIndex(BlockFilterType::BASIC)) {
+        pool.Start(std::min(GetNumCores(), MAX_RESCAN_THREADS) - 1);
+        fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this, pool);
+    }
+    //! The next block known to match, read in the background while the current one is processed.
+    std::optional<std::pair<uint256, std::future<CBlock>>> next_read;
 
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
@@ -1840,7 +1881,20 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         if (fetch_block) {
             // Read block data
             CBlock block;
-            chain().findBlock(block_hash, FoundBlock().data(block));
+            if (next_read && next_read->first == block_hash) {
+                block = pool.Wait(next_read->second);
+            } else {
+                chain().findBlock(block_hash, FoundBlock().data(block));
+            }
+            next_read.reset();
+            // Read the next block that is known to match while this one is processed.
+            if (const auto next_match{fast_rescan_filter ? fast_rescan_filter->NextMatchingBlock() : std::nullopt}) {
+                next_read.emplace(*next_match, pool.Submit([this, hash = *next_match] {
+                    CBlock next_block;
+                    chain().findBlock(hash, FoundBlock().data(next_block));
+                    return next_block;
+                }));
+            }
 
             if (!block.IsNull()) {
                 LOCK(cs_wallet);
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Copyright (c) The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test addressindex.
+
+Test that getaddresshistory and the /rest/addresshistory endpoint return
+the transactions paying to and spending from an address.
+"""
+
+from decimal import Decimal
+import http.client
+import json
+import urllib.parse
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import (
+    MiniWallet,
+    getnewdestination,
+)
+
+
+class AddressIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+        self.extra_args = [
+            ["-addressindex", "-rest"],
+            [],
+        ]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        self.generate(self.wallet, 101)
+        self.wait_until(lambda: node.getindexinfo()["addressindex"]["synced"])
+
+        self.log.info("Check coinbase outputs are indexed")
+        history = node.getaddresshistory(self.wallet.get_address())
+        assert_equal([entry["height"] for entry in history], list(range(1, 102)))
+        assert all(entry["type"] == "receive" for entry in history)
+        assert_equal(history[0]["blockhash"], node.getblockhash(1))
+
+        self.log.info("Check history within a range of heights")
+        history = node.getaddresshistory(self.wallet.get_address(), 10, 19)
+        assert_equal([entry["height"] for entry in history], list(range(10, 20)))
+
+        self.log.info("Check history is returned in pages")
+        full = node.getaddresshistory(self.wallet.get_address())
+        assert_equal(node.getaddresshistory(self.wallet.get_address(), 0, 101, 10), full[:10])
+        assert_equal(node.getaddresshistory(self.wallet.get_address(), 0, 101, 10, 95), full[95:])
+        assert_equal(node.getaddresshistory(self.wallet.get_address(), 0, 101, 10, 101), [])
+
+        self.log.info("Check funding and spending transactions are indexed")
+        _, dest_script, dest_address = getnewdestination()
+        sent = self.wallet.send_to(from_node=node, scriptPubKey=dest_script, amount=12345)
+        block_hash = self.generate(self.wallet, 1)[0]
+        expected = [{
+            "txid": sent["txid"],
+            "height": 102,
+            "blockhash": block_hash,
+            "type": "receive",
+            "vout": sent["sent_vout"],
+            "value": Decimal("0.00012345"),
+        }]
+        assert_equal(node.getaddresshistory(dest_address), expected)
+
+        history = node.getaddresshistory(self.wallet.get_address(), 102)
+        spends = [entry for entry in history if entry["type"] == "spend"]
+        assert_equal(len(spends), 1)
+        assert_equal(spends[0]["txid"], sent["txid"])
+        assert_equal(spends[0]["vin"], 0)
+        assert_equal(spends[0]["prevout_txid"], f"{sent['tx'].vin[0].prevout.hash:064x}")
+
+        self.log.info("Check the REST interface")
+        url = urllib.parse.urlparse(node.url)
+        for path, result in [(dest_address, expected),
+                             (f"{dest_address}/0/101", []),
+                             (f"{self.wallet.get_address()}/10/19", node.getaddresshistory(self.wallet.get_address(), 10, 19))]:
+            conn = http.client.HTTPConnection(url.hostname, url.port)
+            conn.request("GET", f"/rest/addresshistory/{path}.json")
+            response = conn.getresponse()
+            assert_equal(response.status, 200)
+            assert_equal(json.loads(response.read().decode("utf-8"), parse_float=Decimal), result)
+
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request("GET", f"/rest/addresshistory/{self.wallet.get_address()}.json?count=3&skip=5")
+        response = conn.getresponse()
+        assert_equal(response.status, 200)
+        assert_equal([entry["height"] for entry in json.loads(response.read().decode("utf-8"))], [6, 7, 8])
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request("GET", f"/rest/addresshistory/{dest_address}.json?count=0")
+        assert_equal(conn.getresponse().status, 400)
+
+        self.log.info("Check errors")
+        assert_raises_rpc_error(-5, "Invalid address", node.getaddresshistory, "notanaddress")
+        assert_raises_rpc_error(-8, "Invalid height range", node.getaddresshistory, dest_address, 10, 9)
+        assert_raises_rpc_error(-8, "Count must be between 1 and 10000", node.getaddresshistory, dest_address, 0, 10, 0)
+        assert_raises_rpc_error(-8, "Negative skip", node.getaddresshistory, dest_address, 0, 10, 10, -1)
+        assert_raises_rpc_error(-1, "Address index is not enabled", self.nodes[1].getaddresshistory, dest_address)
+
+
+if __name__ == '__main__':
+    AddressIndexTest(__file__).main()
@@ -78,6 +78,16 @@ class ReindexTest(BitcoinTestFramework):
         # All blocks should be accepted and processed.
         assert_equal(self.nodes[0].getblockcount(), 12)
 
+    # Check the parallel reindex path on the out of order blocks from the previous test
+    def out_of_order_parallel(self):
+        self.stop_nodes()
+        with self.nodes[0].assert_debug_log([
+            'ReindexBlockFilesParallel: Out of order block',
+            'Reindexing block file blk00000.dat',
+        ]):
+            self.start_nodes([["-reindex", "-reindexthreads=2"]])
+        assert_equal(self.nodes[0].getblockcount(), 12)
+
     def continue_reindex_after_shutdown(self):
         node = self.nodes[0]
         self.generate(node, 1500)
@@ -104,6 +114,7 @@ class ReindexTest(BitcoinTestFramework):
         self.reindex(True)
 
         self.out_of_order()
+        self.out_of_order_parallel()
         self.continue_reindex_after_shutdown()
 
 
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Copyright (c) The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test spentindex.
+
+Test that gettxspendingprevout reports outputs spent in the active chain
+when the spent-output index is enabled, and follows reorgs.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+
+class SpentIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [
+            ["-spentindex"],
+            [],
+        ]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        self.wait_until(lambda: node.getindexinfo()["spentindex"]["synced"])
+
+        tx = self.wallet.send_self_transfer(from_node=node)
+        prevout = tx["tx"].vin[0].prevout
+        query = [{"txid": f"{prevout.hash:064x}", "vout": prevout.n}]
+
+        self.log.info("Check outputs spent in the mempool are reported without a height")
+        mempool_result = [{**query[0], "spendingtxid": tx["txid"]}]
+        assert_equal(node.gettxspendingprevout(query), mempool_result)
+
+        self.log.info("Check outputs spent in a block are reported with their input and height")
+        block_hash = self.generate(node, 1)[0]
+        height = node.getblock(block_hash)["height"]
+        assert_equal(node.gettxspendingprevout(query), [{**query[0], "spendingtxid": tx["txid"], "vin": 0, "blockheight": height}])
+
+        self.log.info("Check nodes without the index only report mempool spends")
+        assert_equal(self.nodes[1].gettxspendingprevout(query), query)
+
+        self.log.info("Check the index follows a reorg")
+        node.invalidateblock(block_hash)
+        assert_equal(node.gettxspendingprevout(query), mempool_result)
+        node.reconsiderblock(block_hash)
+        self.wait_until(lambda: node.getindexinfo()["spentindex"]["best_block_height"] == height)
+        assert_equal(node.gettxspendingprevout(query)[0]["blockheight"], height)
+
+        self.log.info("Check unspent outputs are not reported")
+        unspent = [{"txid": tx["txid"], "vout": 0}]
+        assert_equal(node.gettxspendingprevout(unspent), unspent)
+
+
+if __name__ == '__main__':
+    SpentIndexTest(__file__).main()
@@ -60,6 +60,18 @@ class DumptxoutsetTest(BitcoinTestFramework):
             out['txoutset_hash'], 'd4453995f4f20db7bb3a604afd10d7128e8ee11159cde56d5b2fd7f55be7c74c')
         assert_equal(out['nchaintx'], 101)
 
+        self.log.info("Test that a dump using worker threads is identical to the serial dump")
+        out_threaded = node.dumptxoutset('txoutset_threaded.dat', "latest", threads=2)
+        assert_equal(out_threaded['coins_written'], out['coins_written'])
+        assert_equal(out_threaded['txoutset_hash'], out['txoutset_hash'])
+        assert_equal(
+            sha256sum_file(out_threaded['path']).hex(),
+            sha256sum_file(str(expected_path)).hex())
+        assert_equal(out_threaded['txoutset_muhash'], node.gettxoutsetinfo("muhash")['muhash'])
+        assert 'txoutset_muhash' not in out
+        assert_raises_rpc_error(
+            -8, 'threads must be between 0 and 16', node.dumptxoutset, 'utxos.dat', "latest", threads=17)
+
         # Specifying a path to an existing or invalid file will fail.
         assert_raises_rpc_error(
             -8, '{} already exists'.format(FILENAME),  node.dumptxoutset, FILENAME, "latest")
@@ -9,13 +9,13 @@ from test_framework.util import (
     assert_equal, assert_is_hex_string, assert_raises_rpc_error,
     )
 
-FILTER_TYPES = ["basic"]
+FILTER_TYPES = ["basic", "stake"]
 
 class GetBlockFilterTest(BitcoinTestFramework):
     def set_test_params(self):
         self.setup_clean_chain = True
         self.num_nodes = 2
-        self.extra_args = [["-blockfilterindex"], []]
+        self.extra_args = [["-blockfilterindex=basic", "-blockfilterindex=stake"], []]
 
     def run_test(self):
         # Create two chains by disconnecting nodes 0 & 1, mining, then reconnecting
@@ -54,6 +54,11 @@ class GetBlockFilterTest(BitcoinTestFramework):
         genesis_hash = self.nodes[0].getblockhash(0)
         assert_raises_rpc_error(-5, "Unknown filtertype", self.nodes[0].getblockfilter, genesis_hash, "unknown")
 
+        # Test -blockfilterindex=1 only enables the basic filter index
+        self.restart_node(0, extra_args=["-blockfilterindex=1"])
+        assert_is_hex_string(self.nodes[0].getblockfilter(genesis_hash, "basic")['filter'])
+        assert_raises_rpc_error(-1, "Index is not enabled for filtertype stake", self.nodes[0].getblockfilter, genesis_hash, "stake")
+
         # Test getblockfilter fails on node without compact block filter index
         self.restart_node(0, extra_args=["-blockfilterindex=0"])
         for filter_type in FILTER_TYPES:
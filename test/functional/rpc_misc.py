@@ -99,6 +99,13 @@ class RpcMiscTest(BitcoinTestFramework):
         # Specifying an unknown index name returns an empty result
         assert_equal(node.getindexinfo("foo"), {})
 
+        # Verbose output includes commit metrics; each index committed at least once while syncing
+        for info in node.getindexinfo("", True).values():
+            assert_equal(info["synced"], True)
+            assert_greater_than(info["commits"]["count"], 0)
+            assert_greater_than_or_equal(info["commits"]["max_latency_us"], info["commits"]["last_latency_us"])
+        assert "commits" not in node.getindexinfo("txindex", False)["txindex"]
+
 
 if __name__ == '__main__':
     RpcMiscTest(__file__).main()
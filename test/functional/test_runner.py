@@ -339,7 +339,9 @@ BASE_SCRIPTS = [
     'feature_logging.py',
     'feature_anchors.py',
     'mempool_datacarrier.py',
+    'feature_addressindex.py',
     'feature_coinstatsindex.py',
+    'feature_spentindex.py',
     'wallet_orphanedreward.py',
     'wallet_timelock.py',
     'p2p_permissions.py',